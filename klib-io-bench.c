@@ -0,0 +1,746 @@
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+
+        Library Name:           
+								Klib-io (for RealDigital Blackboard)
+        
+        Version:                
+								1.2.0 (Benchmarks)
+
+        Contributor(s):         
+								Koby Miller
+                                Dr. Jacob Murray
+
+        Date last modified:     
+								October 17th, 2026
+
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        Microbenchmarks
+
+            Runs every klib-io entry point against the simulated register
+            file and prints one JSON document with, per entry point:
+                ns_per_op               wall time per call
+                mmio_reads_per_op       register loads per call
+                mmio_writes_per_op      register stores per call
+                instructions_per_op     retired user-space instructions per call
+                items_per_sec           calls per second, times items_per_op
+
+            Build it together with the library, counting bus accesses:
+                gcc -O2 -DKLIB_IO_COUNT_MMIO klib-io.c klib-io-bench.c -o klib-io-bench -pthread
+
+            Without KLIB_IO_COUNT_MMIO the MMIO columns read 0. Instruction
+            counts come from perf_event_open() and read -1 where it is not
+            allowed (see /proc/sys/kernel/perf_event_paranoid).
+
+            Built with -DKLIB_IO_THREADSAFE as well, a "threads" object
+            follows the results: lost updates from threads sharing one
+            register (must be 0), and total calls per second as threads
+            driving different peripherals are added, with the library's
+            per-peripheral locks against one application-wide mutex. With
+            8 threads, an RGB animation ticks on each LED next to the
+            fixed-color writes.
+            The MMIO counters are not atomic and drift in that section.
+
+            On Linux an "output_queue" object reports the async output
+            queue: one producer thread per display peripheral submitting
+            at BENCH_QUEUE_HZ against the I/O thread, and the coalescing
+            ratio that results.
+
+            The batch seven-segment encoders take whichever SIMD path the
+            compiler targets: add -march=native (or -mfpu=neon on the board)
+            to compare them with the scalar loops.
+
+            Usage: ./klib-io-bench [iterations]
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+
+#define _DEFAULT_SOURCE // syscall() and pthread barriers under -std=c11
+
+#include "klib-io.h"
+#include <stdio.h>
+#include <string.h>
+#ifdef __linux__
+    #include <linux/perf_event.h>
+    #include <sys/ioctl.h>
+    #include <sys/syscall.h>
+#endif
+
+#define BENCH_ITERATIONS 200000
+#define BENCH_BURST 1024            // nibbles per burst call
+#define BENCH_MAX_THREADS 8
+#define BENCH_BATCH 1024            // values per batch encoder call
+#define BENCH_QUEUE_HZ 50000        // commands per second from each output queue producer
+
+typedef struct {
+    const char* name;
+    void (*fn)(unsigned int i);
+    unsigned int items;             // items handled by one call (e.g. nibbles per burst)
+    unsigned int divisor;           // iterations are divided by this for slow entry points
+} benchEntry;
+
+static const char* bench_text[4] = {"KLIb", "io  ", "8888", "-AbC"};
+static uint8_t bench_nibbles[BENCH_BURST];
+static pmodSpi bench_spi;
+static boardFrame bench_frame;
+static outputQueue bench_queue;
+static displaySink bench_display;
+#if defined(KLIB_IO_THREADSAFE) && defined(__linux__)
+static rgbAnimation bench_anim[BENCH_MAX_THREADS];
+#endif
+static int bench_values[BENCH_BATCH];
+static char bench_strings[BENCH_BATCH * 4];
+static unsigned int bench_frames[BENCH_BATCH];
+static float bench_floats[BENCH_BATCH];
+static volatile unsigned int bench_sink; // keeps pure functions from being optimized away
+
+// The outputToSevSegCustom() switch-case this library used before its glyph table
+static unsigned int referenceEncode(const char* chars) {
+
+    unsigned int disp = 0;
+    unsigned int temp = 0;
+    int c;
+
+    for(c = 0; c < 4; c++) {
+        switch(chars[c]) {                                                                                        // minimize this line ~
+            case 'A':
+            case 'a':
+                temp = SEVSEG_CHAR_A;
+                break;
+
+            case 'B':
+            case 'b':
+                temp = SEVSEG_CHAR_B;
+                break;
+
+            case 'C':
+                temp = SEVSEG_CHAR_C;
+                break;
+
+            case 'c':
+                temp = SEVSEG_CHAR_c;
+                break;
+
+            case 'D':
+            case 'd':
+                temp = SEVSEG_CHAR_D;
+                break;
+
+            case 'E':
+            case 'e':
+                temp = SEVSEG_CHAR_E;
+                break;
+
+            case 'F':
+            case 'f':
+                temp = SEVSEG_CHAR_F;
+                break;
+
+            case 'G':
+                temp = SEVSEG_CHAR_G;
+                break;
+
+            case 'g':
+                temp = SEVSEG_CHAR_g;
+                break;
+
+            case 'H':
+                temp = SEVSEG_CHAR_H;
+                break;
+
+            case 'h':
+                temp = SEVSEG_CHAR_h;
+                break;
+
+            case 'I':
+                temp = SEVSEG_CHAR_I;
+                break;
+
+            case 'i':
+                temp = SEVSEG_CHAR_i;
+                break;
+
+            case 'J':
+            case 'j':
+                temp = SEVSEG_CHAR_J;
+                break;
+
+            case 'L':
+                temp = SEVSEG_CHAR_L;
+                break;
+
+            case 'l':
+                temp = SEVSEG_CHAR_l;
+                break;
+
+            case 'N':
+                temp = SEVSEG_CHAR_N;
+                break;
+
+            case 'n':
+                temp = SEVSEG_CHAR_n;
+                break;
+
+            case 'O':
+                temp = SEVSEG_CHAR_O;
+                break;
+
+            case 'o':
+                temp = SEVSEG_CHAR_o;
+                break;
+
+            case 'P':
+            case 'p':
+                temp = SEVSEG_CHAR_P;
+                break;
+
+            case 'Q':
+            case 'q':
+                temp = SEVSEG_CHAR_Q;
+                break;
+
+            case 'R':
+            case 'r':
+                temp = SEVSEG_CHAR_R;
+                break;
+
+            case 'S':
+            case 's':
+                temp = SEVSEG_CHAR_S;
+                break;
+
+            case 'T':
+            case 't':
+                temp = SEVSEG_CHAR_T;
+                break;
+
+            case 'U':
+                temp = SEVSEG_CHAR_U;
+                break;
+
+            case 'u':
+                temp = SEVSEG_CHAR_u;
+                break;
+
+            case 'Y':
+            case 'y':
+                temp = SEVSEG_CHAR_Y;
+                break;
+
+            case '1':
+                temp = SEVSEG_CHAR_1;
+                break;
+
+            case '2':
+                temp = SEVSEG_CHAR_2;
+                break;
+
+            case '3':
+                temp = SEVSEG_CHAR_3;
+                break;
+
+            case '4':
+                temp = SEVSEG_CHAR_4;
+                break;
+
+            case '5':
+                temp = SEVSEG_CHAR_5;
+                break;
+
+            case '6':
+                temp = SEVSEG_CHAR_6;
+                break;
+
+            case '7':
+                temp = SEVSEG_CHAR_7;
+                break;
+
+            case '8':
+                temp = SEVSEG_CHAR_8;
+                break;
+
+            case '9':
+                temp = SEVSEG_CHAR_9;
+                break;
+
+            case '0':
+                temp = SEVSEG_CHAR_0;
+                break;
+
+            case '-':
+                temp = SEVSEG_CHAR_DASH;
+                break;
+
+            case '=':
+                temp = SEVSEG_CHAR_EQUAL;
+                break;
+
+            case '_':
+                temp = SEVSEG_CHAR_UNDERSCORE;
+                break;
+
+            default:
+                temp = SEVSEG_CHAR_BLANK;
+                break;
+        }
+        disp |= temp << (24 - c * 8);
+    }
+
+    return disp | 0x80808080;
+}
+
+// The snprintf() route to a decimal point: print with fewer decimals until it fits, then fold each '.' into the digit before it
+static unsigned int referenceFloat(float val) {
+
+    char text[48];
+    char chars[5] = "    ";
+    unsigned int points = 0;
+    int decimals, len, c, d;
+
+    for(decimals = 3; decimals >= 0; decimals--) {
+        len = snprintf(text, sizeof(text), "%.*f", decimals, val);
+        if(len - (decimals > 0) <= 4) {
+            break;
+        }
+    }
+    if(decimals < 0 || val != val) {
+        return encodeSevSegChars("----");
+    }
+
+    for(c = len - 1, d = 3; c >= 0; c--) {
+        if(text[c] == '.') {
+            points |= 0x80u << ((3 - d) * 8); // lands on the digit placed next
+        } else {
+            chars[d--] = text[c];
+        }
+    }
+
+    return encodeSevSegChars(chars) & ~points;
+}
+
+static void benchSevSegHex(unsigned int i)          { outputToSevSeg((int)i, 0); }
+static void benchSevSegDec(unsigned int i)          { outputToSevSeg((int)(i % 10000), 1); }
+static void benchSevSegCustom(unsigned int i)       { outputToSevSegCustom(bench_text[i & 3]); }
+static void benchEncodeTable(unsigned int i)        { bench_sink = encodeSevSegChars(bench_text[i & 3]); }
+static void benchEncodeSwitch(unsigned int i)       { bench_sink = referenceEncode(bench_text[i & 3]); }
+static void benchLEDs(unsigned int i)               { outputToLEDs((int)i); }
+static void benchEnableRGB(unsigned int i)          { enableRGB(i & 3); }
+static void benchRGB(unsigned int i)                { outputToRGB(i & 1, i * 0x010203, 0.5f); }
+static void benchRGBFixed(unsigned int i)           { outputToRGBFixed(i & 1, i * 0x010203, 0x8000); }
+static void benchButtons(unsigned int i)            { (void)i; bench_sink = getButtonStates(); }
+static void benchPmodRead(unsigned int i)           { bench_sink = pmodRead(i & 1); }
+static void benchPmodWrite(unsigned int i)          { pmodWrite(i & 1, i & 0xF); }
+static void benchPmodReadWrite(unsigned int i)      { pmodWrite(0, i & 0xF); bench_sink = pmodRead(1); }
+static void benchPmodWriteBurst(unsigned int i)     { pmodWriteBurst(i & 1, bench_nibbles, BENCH_BURST); }
+static void benchPmodReadBurst(unsigned int i)      { pmodReadBurst(i & 1, bench_nibbles, BENCH_BURST); }
+static void benchSpiByte(unsigned int i)            { uint8_t b = (uint8_t)i; pmodSpiTransfer(&bench_spi, &b, &b, 1); }
+static void benchFrameCommit(unsigned int i)        { frameLEDs(&bench_frame, (int)i); frameSevSeg(&bench_frame, (int)(i % 10000), 1); commitBoardFrame(&bench_frame); }
+static void benchGetNanos(unsigned int i)           { (void)i; bench_sink = (unsigned int)getNanos(); }
+static void benchSinkSevSeg(unsigned int i)         { sinkSevSeg(&bench_display, (int)(i % 10000), 1); }
+static void benchBatchDec(unsigned int i)           { (void)i; encodeSevSegValues(bench_values, bench_frames, BENCH_BATCH, 1); }
+static void benchBatchHex(unsigned int i)           { (void)i; encodeSevSegValues(bench_values, bench_frames, BENCH_BATCH, 0); }
+static void benchBatchStrings(unsigned int i)       { (void)i; encodeSevSegStrings(bench_strings, bench_frames, BENCH_BATCH); }
+static void benchScalarDec(unsigned int i) {
+    (void)i;
+    for(unsigned int v = 0; v < BENCH_BATCH; v++) {
+        bench_frames[v] = encodeSevSegValue(bench_values[v], 1);
+    }
+}
+static void benchScalarStrings(unsigned int i) {
+    (void)i;
+    for(unsigned int v = 0; v < BENCH_BATCH; v++) {
+        bench_frames[v] = encodeSevSegChars(bench_strings + v * 4);
+    }
+}
+static void benchSevSegFixed(unsigned int i)        { outputToSevSegFixed((int)(i % 20000) - 999, 2); }
+static void benchSevSegFloat(unsigned int i)        { outputToSevSegFloat(bench_floats[i & (BENCH_BATCH - 1)]); }
+static void benchSevSegFloatPrintf(unsigned int i)  { outputToSevSegFrame(referenceFloat(bench_floats[i & (BENCH_BATCH - 1)])); }
+static void benchSevSegDigit(unsigned int i)        { setSevSegDigit(0, i % 10); }
+static void benchQueueLEDs(unsigned int i)          { queueLEDs(&bench_queue, (int)i); if((i & 63) == 63) flushOutputQueue(&bench_queue); }
+
+static const benchEntry bench_entries[] = {
+    {"outputToSevSeg_hex",          benchSevSegHex,         1,              1},
+    {"outputToSevSeg_dec",          benchSevSegDec,         1,              1},
+    {"outputToSevSegCustom",        benchSevSegCustom,      1,              1},
+    {"encodeSevSegChars_table",     benchEncodeTable,       1,              1},
+    {"encodeSevSegChars_switch",    benchEncodeSwitch,      1,              1},
+    {"outputToLEDs",                benchLEDs,              1,              1},
+    {"enableRGB",                   benchEnableRGB,         1,              1},
+    {"outputToRGB",                 benchRGB,               1,              1},
+    {"outputToRGBFixed",            benchRGBFixed,          1,              1},
+    {"getButtonStates",             benchButtons,           1,              1},
+    {"pmodRead",                    benchPmodRead,          1,              1},
+    {"pmodWrite",                   benchPmodWrite,         1,              1},
+    {"pmodWrite_pmodRead_turn",     benchPmodReadWrite,     1,              1},
+    {"pmodWriteBurst_nibbles",      benchPmodWriteBurst,    BENCH_BURST,    256},
+    {"pmodReadBurst_nibbles",       benchPmodReadBurst,     BENCH_BURST,    256},
+    {"pmodSpiTransfer_byte",        benchSpiByte,           1,              16},
+    {"commitBoardFrame",            benchFrameCommit,       1,              1},
+    {"getNanos",                    benchGetNanos,          1,              1},
+    {"queueLEDs_flush_every_64",    benchQueueLEDs,         1,              1},
+    {"sinkSevSeg_dec_60hz",         benchSinkSevSeg,        1,              1},
+    {"encodeSevSegValues_dec",      benchBatchDec,          BENCH_BATCH,    256},
+    {"encodeSevSegValue_dec_loop",  benchScalarDec,         BENCH_BATCH,    256},
+    {"encodeSevSegValues_hex",      benchBatchHex,          BENCH_BATCH,    256},
+    {"encodeSevSegStrings",         benchBatchStrings,      BENCH_BATCH,    256},
+    {"encodeSevSegChars_loop",      benchScalarStrings,     BENCH_BATCH,    256},
+    {"outputToSevSegFixed",         benchSevSegFixed,       1,              1},
+    {"outputToSevSegFloat",         benchSevSegFloat,       1,              1},
+    {"outputToSevSegFloat_printf",  benchSevSegFloatPrintf, 1,              1},
+    {"setSevSegDigit",              benchSevSegDigit,       1,              1},
+};
+
+#ifdef __linux__
+typedef struct {
+    pthread_t thread;
+    unsigned int id;
+    unsigned int iterations;
+    bool global;                    // wrap each call in bench_global instead of relying on the library
+    unsigned long lost;             // stress: times the thread found its own bit cleared
+    unsigned long long start, end;  // getNanos() around the thread's own loop
+} benchThread;
+
+static pthread_barrier_t bench_barrier;
+
+// Runs 'n' threads of 'fn' and returns the time from the first thread starting to the last one finishing
+static unsigned long long runThreads(benchThread* t, unsigned int n, void* (*fn)(void*)) {
+
+    unsigned long long first = ~0ULL, last = 0;
+    unsigned int i;
+
+    pthread_barrier_init(&bench_barrier, NULL, n);
+    for(i = 0; i < n; i++) {
+        pthread_create(&t[i].thread, NULL, fn, &t[i]);
+    }
+    for(i = 0; i < n; i++) {
+        pthread_join(t[i].thread, NULL);
+        first = t[i].start < first ? t[i].start : first;
+        last = t[i].end > last ? t[i].end : last;
+    }
+    pthread_barrier_destroy(&bench_barrier);
+
+    return last - first;
+}
+#endif
+
+#if defined(KLIB_IO_THREADSAFE) && defined(__linux__)
+static pthread_mutex_t bench_global = PTHREAD_MUTEX_INITIALIZER;
+
+// Sets and clears its own DIR_2 bit, then adds to the LED register as one locked read-modify-write
+static void* benchStressThread(void* arg) {
+
+    benchThread* t = (benchThread*)arg;
+    const unsigned int bit = 1u << t->id;
+    unsigned int i;
+
+    pthread_barrier_wait(&bench_barrier);
+    t->start = getNanos();
+    for(i = 0; i < t->iterations; i++) {
+        modifyReg(DIR_2, 0, bit);
+        if(!(modifyReg(DIR_2, 0, 0) & bit)) {
+            t->lost++; // another thread stored a stale copy of the register
+        }
+        modifyReg(DIR_2, bit, 0);
+
+        lockPeripheral(KLIB_PERIPH_LEDS);
+        writeReg(LED_ADDR, readReg(LED_ADDR) + 1);
+        unlockPeripheral(KLIB_PERIPH_LEDS);
+    }
+    t->end = getNanos();
+
+    return NULL;
+}
+
+// Drives one peripheral per thread (LEDs, seven-segment, RGB 1, RGB 2); from the fifth
+// thread on, the RGB ones tick an animation against the fixed-color writers
+static void* benchScaleThread(void* arg) {
+
+    benchThread* t = (benchThread*)arg;
+    unsigned int i;
+
+    pthread_barrier_wait(&bench_barrier);
+    t->start = getNanos();
+    for(i = 0; i < t->iterations; i++) {
+        if(t->global) {
+            pthread_mutex_lock(&bench_global);
+        }
+        switch(t->id & 3) {
+            case 0:     outputToLEDs((int)i); break;
+            case 1:     outputToSevSeg((int)(i % 10000), 1); break;
+            default:
+                if(t->id & 4) {
+                    tickRGBAnimation(&bench_anim[t->id], i);
+                } else {
+                    outputToRGBFixed((t->id & 3) - 2, i * 0x010203, 0x8000);
+                }
+                break;
+        }
+        if(t->global) {
+            pthread_mutex_unlock(&bench_global);
+        }
+    }
+    t->end = getNanos();
+
+    return NULL;
+}
+
+
+// Prints the "threads" object
+static void benchThreads(unsigned int iterations) {
+
+    benchThread t[BENCH_MAX_THREADS];
+    unsigned long long ns[2];
+    unsigned long lost = 0;
+    unsigned int n, i, g;
+
+    memset(t, 0, sizeof(t));
+    writeReg(LED_ADDR, 0);
+    for(i = 0; i < BENCH_MAX_THREADS; i++) {
+        t[i].id = i;
+        t[i].iterations = iterations / 8;
+        animateRGBBreathe(&bench_anim[i], i & 1, 0x00FFFF, 100); // ids 6 and 7 tick RGB 1 and RGB 2
+    }
+    runThreads(t, BENCH_MAX_THREADS, benchStressThread);
+    for(i = 0; i < BENCH_MAX_THREADS; i++) {
+        lost += t[i].lost;
+    }
+
+    printf("  \"threads\": {\n");
+    printf("    \"stress_threads\": %u, \"stress_iterations\": %u,\n", BENCH_MAX_THREADS, iterations / 8);
+    printf("    \"lost_bit_updates\": %lu, \"lost_increments\": %lu,\n",
+           lost, (unsigned long)BENCH_MAX_THREADS * (iterations / 8) - readReg(LED_ADDR));
+    printf("    \"scaling\": [\n");
+    for(n = 1; n <= BENCH_MAX_THREADS; n *= 2) {
+        for(g = 0; g < 2; g++) {
+            for(i = 0; i < n; i++) {
+                t[i].iterations = iterations;
+                t[i].global = g;
+            }
+            ns[g] = runThreads(t, n, benchScaleThread);
+        }
+        printf("      {\"threads\": %u, \"per_peripheral_ops_per_sec\": %.0f, \"global_lock_ops_per_sec\": %.0f}%s\n",
+               n, 1e9 * n * iterations / (double)ns[0], 1e9 * n * iterations / (double)ns[1],
+               n * 2 <= BENCH_MAX_THREADS ? "," : "");
+    }
+    printf("    ]\n  }");
+}
+#endif
+
+#ifdef __linux__
+// One producer per display peripheral, submitting at BENCH_QUEUE_HZ
+static void* benchQueueThread(void* arg) {
+
+    benchThread* t = (benchThread*)arg;
+    unsigned int i;
+
+    pthread_barrier_wait(&bench_barrier);
+    t->start = getNanos();
+    for(i = 0; i < t->iterations; i++) {
+        waitUntilNs(t->start + i * (1000000000ULL / BENCH_QUEUE_HZ));
+        switch(t->id & 3) {
+            case 0:     queueLEDs(&bench_queue, (int)i); break;
+            case 1:     queueSevSeg(&bench_queue, (int)(i % 10000), 1); break;
+            default:    queueRGB(&bench_queue, (t->id & 3) - 2, i * 0x010203, 0x8000); break;
+        }
+    }
+    t->end = getNanos();
+
+    return NULL;
+}
+
+// Prints the "output_queue" object
+static void benchOutputQueue(unsigned int iterations) {
+
+    benchThread t[4];
+    outputQueueStats s;
+    unsigned int i;
+
+    memset(t, 0, sizeof(t));
+    for(i = 0; i < 4; i++) {
+        t[i].id = i;
+        t[i].iterations = iterations / 10; // a fifth of a second at the defaults
+    }
+
+    initOutputQueue(&bench_queue, OUTPUT_PERIOD_US);
+    startOutputThread(&bench_queue);
+    runThreads(t, 4, benchQueueThread);
+    stopOutputThread(&bench_queue);
+    getOutputQueueStats(&bench_queue, &s);
+
+    printf("  \"output_queue\": {\"producers\": 4, \"producer_hz\": %u, \"period_us\": %u, "
+           "\"submitted\": %lu, \"written\": %lu, \"coalesced\": %lu, \"coalescing_ratio\": %.1f}",
+           BENCH_QUEUE_HZ, OUTPUT_PERIOD_US, s.submitted, s.written, s.coalesced, s.ratio);
+}
+#endif
+
+// Opens a user-space retired-instruction counter, -1 if the kernel refuses
+static int openInstructionCounter() {
+
+#ifdef __linux__
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#else
+    return -1;
+#endif
+}
+
+// Runs one entry point and prints its JSON object
+static void runBench(const benchEntry* b, unsigned int iterations, int perf_fd, bool last) {
+
+    unsigned long reads0, writes0, reads1, writes1;
+    unsigned long long t0, t1;
+    long long instructions = -1;
+    double ns;
+    unsigned int i;
+
+    iterations = iterations / b->divisor ? iterations / b->divisor : 1;
+
+    for(i = 0; i < iterations / 16 + 1; i++) {
+        b->fn(i); // warm caches, shadow registers and the branch predictor
+    }
+
+    getMmioCounts(&reads0, &writes0);
+#ifdef __linux__
+    if(perf_fd >= 0) {
+        ioctl(perf_fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(perf_fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+    t0 = getNanos();
+
+    for(i = 0; i < iterations; i++) {
+        b->fn(i);
+    }
+
+    t1 = getNanos();
+#ifdef __linux__
+    if(perf_fd >= 0) {
+        ioctl(perf_fd, PERF_EVENT_IOC_DISABLE, 0);
+        if(read(perf_fd, &instructions, sizeof(instructions)) != sizeof(instructions)) {
+            instructions = -1;
+        }
+    }
+#endif
+    getMmioCounts(&reads1, &writes1);
+
+    ns = (double)(t1 - t0) / iterations;
+    printf("    {\"name\": \"%s\", \"iterations\": %u, \"ns_per_op\": %.2f, "
+           "\"mmio_reads_per_op\": %.2f, \"mmio_writes_per_op\": %.2f, \"instructions_per_op\": %.1f, "
+           "\"items_per_op\": %u, \"items_per_sec\": %.0f}%s\n",
+           b->name, iterations, ns,
+           (double)(reads1 - reads0) / iterations, (double)(writes1 - writes0) / iterations,
+           instructions < 0 ? -1.0 : (double)instructions / iterations,
+           b->items, ns > 0 ? 1e9 / ns * b->items : 0.0, last ? "" : ",");
+}
+
+int main(int argc, char** argv) {
+
+    const unsigned int count = sizeof(bench_entries) / sizeof(bench_entries[0]);
+    unsigned int iterations = BENCH_ITERATIONS;
+    int perf_fd;
+    unsigned int i;
+    byte mode;
+
+    if(argc > 1) {
+        iterations = (unsigned int)strtoul(argv[1], NULL, 10);
+        if(iterations == 0) {
+            iterations = BENCH_ITERATIONS;
+        }
+    }
+
+    if(initKlibIo(KLIB_BACKEND_SIM) != 0) {
+        fprintf(stderr, "klib-io-bench: could not set up the simulated backend\n");
+        return 1;
+    }
+
+    // the batch encoders must agree with the scalar reference, same reason
+    for(i = 0; i < BENCH_BATCH; i++) {
+        bench_values[i] = (int)(i * 2654435761u) % 12000 - 1500; // includes the dash and "----" cases
+        memcpy(bench_strings + i * 4, bench_text[i & 3], 4);
+    }
+    for(mode = 0; mode < 3; mode++) { // hexadecimal, decimal and binary each have their own SIMD path
+        encodeSevSegValues(bench_values, bench_frames, BENCH_BATCH, mode);
+        for(i = 0; i < BENCH_BATCH; i++) {
+            if(bench_frames[i] != encodeSevSegValue(bench_values[i], mode)) {
+                fprintf(stderr, "klib-io-bench: %s batch encoder disagrees on %d in mode %d\n",
+                        getSevSegBatchPath(), bench_values[i], mode);
+                return 1;
+            }
+        }
+    }
+    encodeSevSegStrings(bench_strings, bench_frames, BENCH_BATCH);
+    for(i = 0; i < BENCH_BATCH; i++) {
+        if(bench_frames[i] != encodeSevSegChars(bench_strings + i * 4)) {
+            fprintf(stderr, "klib-io-bench: %s string encoder disagrees on record %u\n", getSevSegBatchPath(), i);
+            return 1;
+        }
+    }
+
+    // the float formatter must agree with snprintf(); these values avoid exact halves, which printf rounds to even
+    for(i = 0; i < BENCH_BATCH; i++) {
+        bench_floats[i] = (float)((int)(i * 2654435761u % 2400000) - 200000) / 137.0f; // includes "----"
+        if(encodeSevSegFloat(bench_floats[i]) != referenceFloat(bench_floats[i])) {
+            fprintf(stderr, "klib-io-bench: encodeSevSegFloat() and snprintf() disagree on %g\n", bench_floats[i]);
+            return 1;
+        }
+    }
+
+    // the table must agree with the switch it replaced, or the comparison is moot
+    for(i = 0; i < 4; i++) {
+        if(encodeSevSegChars(bench_text[i]) != referenceEncode(bench_text[i])) {
+            fprintf(stderr, "klib-io-bench: glyph table and switch-case disagree on \"%s\"\n", bench_text[i]);
+            return 1;
+        }
+    }
+
+    for(i = 0; i < BENCH_BURST; i++) {
+        bench_nibbles[i] = (uint8_t)(i * 7) & 0xF;
+    }
+    enableSevSeg(1);
+    enableRGB(0b11);
+    initPmodSpi(&bench_spi, PMODB_PIN(1, 0), PMODB_PIN(1, 1), PMODB_PIN(1, 2), PMODB_PIN(1, 3), 0, 0);
+    readBoardFrame(&bench_frame);
+    initOutputQueue(&bench_queue, 0);
+    initDisplaySink(&bench_display, 0);
+
+    perf_fd = openInstructionCounter();
+
+    printf("{\n");
+#ifdef KLIB_IO_COUNT_MMIO
+    printf("  \"mmio_counted\": true,\n");
+#else
+    printf("  \"mmio_counted\": false,\n");
+#endif
+    printf("  \"instructions_counted\": %s,\n", perf_fd >= 0 ? "true" : "false");
+    printf("  \"backend\": \"sim\",\n");
+    printf("  \"sevseg_batch_path\": \"%s\",\n", getSevSegBatchPath());
+    printf("  \"results\": [\n");
+    for(i = 0; i < count; i++) {
+        runBench(&bench_entries[i], iterations, perf_fd, i + 1 == count);
+    }
+    printf("  ]");
+#if defined(KLIB_IO_THREADSAFE) && defined(__linux__)
+    printf(",\n");
+    benchThreads(iterations);
+#endif
+#ifdef __linux__
+    printf(",\n");
+    benchOutputQueue(iterations);
+#endif
+    printf("\n}\n");
+
+    if(perf_fd >= 0) {
+        close(perf_fd);
+    }
+    closeKlibIo();
+
+    return 0;
+}
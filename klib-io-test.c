@@ -0,0 +1,411 @@
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+
+        Library Name:           
+								Klib-io (for RealDigital Blackboard)
+        
+        Version:                
+								1.2.0 (Tests)
+
+        Contributor(s):         
+								Koby Miller
+                                Dr. Jacob Murray
+
+        Date last modified:     
+								October 17th, 2026
+
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        Tests
+
+            Runs against the simulated register file, no board needed:
+            SPI in modes 0-3, UART and I2C in loopback through the
+            simulated PMOD B wires and I2C slave, input debouncing and
+            hold/repeat, per-digit seven-segment updates, RGB LED
+            selection and long animations, the output queue's last writer
+            wins, the display sink after a burst, and waitForInput() woken
+            through an eventfd. Prints one line per check that fails and
+            exits non-zero if any did.
+
+            Build and run it together with the library:
+                gcc -O2 klib-io.c klib-io-test.c -o klib-io-test -pthread && ./klib-io-test
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+
+#define _DEFAULT_SOURCE // eventfd and pthreads under -std=c11
+
+#include "klib-io.h"
+#include <stdio.h>
+#include <string.h>
+#ifdef __linux__
+    #include <sys/eventfd.h>
+#endif
+
+static unsigned int test_checks = 0;
+static unsigned int test_failures = 0;
+
+#define CHECK(cond) testCheck((cond), #cond, __func__, __LINE__)
+
+static void testCheck(bool ok, const char* what, const char* test, int line) {
+
+    test_checks++;
+    if(!ok) {
+        test_failures++;
+        fprintf(stderr, "FAIL %s:%d: %s\n", test, line, what);
+    }
+}
+
+#define TEST_UART_BAUD 20 // 50 ms bits, wide enough for two threads taking turns on one core
+
+static const uint8_t test_bytes[4] = {0xA5, 0x00, 0xFF, 0x3C};
+
+// SPI in every mode with MOSI wired back to MISO
+static void testSpiLoopback() {
+
+    const uint8_t sck = PMODB_PIN(0, 0);
+    const uint8_t mosi = PMODB_PIN(0, 1);
+    const uint8_t miso = PMODB_PIN(0, 2);
+    const uint8_t cs = PMODB_PIN(0, 3);
+    pmodSpi spi;
+    uint8_t rx[sizeof(test_bytes)];
+    byte mode;
+
+    simPmodConnect(mosi, miso);
+
+    for(mode = 0; mode < 4; mode++) {
+        initPmodSpi(&spi, sck, mosi, miso, cs, mode, 0);
+        memset(rx, 0x55, sizeof(rx));
+        pmodSpiTransfer(&spi, test_bytes, rx, sizeof(test_bytes));
+
+        CHECK(memcmp(rx, test_bytes, sizeof(test_bytes)) == 0);
+        CHECK(((readReg(DATA_2_RO) >> (7 + sck)) & 1) == (unsigned int)(mode >> 1)); // SCK back at its idle level (CPOL)
+        CHECK(((readReg(DATA_2_RO) >> (7 + cs)) & 1) == 1); // chip select released
+    }
+
+    simPmodConnect(0xFF, miso);
+}
+
+#ifdef __linux__
+typedef struct {
+    pmodUart* uart;
+    uint8_t data[sizeof(test_bytes)];
+    size_t received;
+} testUartReader;
+
+static void* testUartReaderThread(void* arg) {
+
+    testUartReader* r = arg;
+
+    r->received = pmodUartRead(r->uart, r->data, sizeof(r->data), 2000);
+
+    return NULL;
+}
+
+// UART TX wired to RX, received by a second thread while the first one sends
+static void testUartLoopback() {
+
+    const uint8_t tx = PMODB_PIN(1, 0);
+    const uint8_t rx = PMODB_PIN(1, 1);
+    pmodUart uart;
+    testUartReader reader = {&uart, {0}, 0};
+    pthread_t thread;
+
+    simPmodConnect(tx, rx);
+    initPmodUart(&uart, tx, rx, TEST_UART_BAUD);
+
+    CHECK(pthread_create(&thread, NULL, testUartReaderThread, &reader) == 0);
+    delayNs(50000000); // let the reader reach its start bit wait
+    pmodUartWrite(&uart, test_bytes, sizeof(test_bytes));
+    pthread_join(thread, NULL);
+
+    CHECK(reader.received == sizeof(test_bytes));
+    CHECK(memcmp(reader.data, test_bytes, sizeof(test_bytes)) == 0);
+
+    // nothing more on the line: times out with no bytes
+    CHECK(pmodUartRead(&uart, reader.data, 1, 20) == 0);
+
+    simPmodConnect(0xFF, rx);
+}
+#endif
+
+// I2C against the simulated slave: ACK at its address, NACK anywhere else
+static void testI2cSlave() {
+
+    const uint8_t scl = PMODB_PIN(1, 2);
+    const uint8_t sda = PMODB_PIN(1, 3);
+    pmodI2c i2c;
+    uint8_t got[sizeof(test_bytes)];
+
+    simPmodI2cSlave(scl, sda, 0x42);
+    initPmodI2c(&i2c, scl, sda, 100000);
+
+    CHECK(pmodI2cWrite(&i2c, 0x42, test_bytes, sizeof(test_bytes)) == 0);
+    CHECK(simPmodI2cReceived(got, sizeof(got)) == sizeof(test_bytes));
+    CHECK(memcmp(got, test_bytes, sizeof(test_bytes)) == 0);
+
+    CHECK(pmodI2cWrite(&i2c, 0x43, test_bytes, sizeof(test_bytes)) == -1);
+    CHECK(pmodI2cRead(&i2c, 0x42, got, 2) == 0);
+    CHECK(got[0] == 0xFF && got[1] == 0xFF); // the slave has no data of its own
+    CHECK(pmodI2cRead(&i2c, 0x10, got, 1) == -1);
+
+    // the NACKed transfers were not taken as data
+    CHECK(simPmodI2cReceived(got, sizeof(got)) == sizeof(test_bytes));
+
+    // both lines released after the STOP
+    CHECK(((readReg(DATA_2_RO) >> (7 + scl)) & 1) == 1);
+    CHECK(((readReg(DATA_2_RO) >> (7 + sda)) & 1) == 1);
+
+    simPmodI2cSlave(0xFF, 0xFF, 0);
+}
+
+// Input engine: 4 identical samples to change state, bounce starts the count over, and
+// only buttons repeat while held. One sample per simulated millisecond.
+static void testInputEngine() {
+
+    inputEngine e;
+    inputEvent ev;
+    unsigned long now = 0;
+    int i;
+
+    initInputEngine(&e, 1000, 10, 5);
+    writeReg(BUTTONS_ADDR, 0);
+    writeReg(SWITCHES_ADDR, 0);
+
+    // button 1 pressed, with one bouncing sample after the third
+    writeReg(BUTTONS_ADDR, 0x2);
+    for(i = 0; i < 3; i++) {
+        sampleInputs(&e, ++now);
+    }
+    writeReg(BUTTONS_ADDR, 0);
+    sampleInputs(&e, ++now);
+    writeReg(BUTTONS_ADDR, 0x2);
+    for(i = 0; i < 3; i++) {
+        sampleInputs(&e, ++now);
+    }
+    CHECK(!nextInputEvent(&e, &ev));
+    CHECK(getDebouncedInputs(&e) == 0);
+
+    sampleInputs(&e, ++now); // the 4th in a row
+    CHECK(nextInputEvent(&e, &ev) && ev.input == INPUT_BUTTON(1) && ev.type == INPUT_EVENT_PRESS && ev.time == now);
+    CHECK(getDebouncedInputs(&e) == 0x2);
+
+    // switch 0 turned on and left on: one press, never a hold or repeat
+    writeReg(SWITCHES_ADDR, 0x1);
+
+    // HOLD 10 samples after the press, then a REPEAT every 5
+    for(i = 1; i <= 20; i++) {
+        sampleInputs(&e, ++now);
+        if(i == 4) {
+            CHECK(nextInputEvent(&e, &ev) && ev.input == INPUT_SWITCH(0) && ev.type == INPUT_EVENT_PRESS);
+        } else if(i == 10) {
+            CHECK(nextInputEvent(&e, &ev) && ev.input == INPUT_BUTTON(1) && ev.type == INPUT_EVENT_HOLD);
+        } else if(i == 15 || i == 20) {
+            CHECK(nextInputEvent(&e, &ev) && ev.input == INPUT_BUTTON(1) && ev.type == INPUT_EVENT_REPEAT);
+        }
+        CHECK(!nextInputEvent(&e, &ev));
+    }
+
+    // button released, the switch stays on for 500 samples without another event
+    writeReg(BUTTONS_ADDR, 0);
+    for(i = 0; i < 500; i++) {
+        sampleInputs(&e, ++now);
+    }
+    CHECK(nextInputEvent(&e, &ev) && ev.input == INPUT_BUTTON(1) && ev.type == INPUT_EVENT_RELEASE);
+    CHECK(!nextInputEvent(&e, &ev));
+    CHECK(e.dropped == 0);
+    CHECK(getDebouncedInputs(&e) == 0x10);
+
+    writeReg(SWITCHES_ADDR, 0);
+}
+
+// Per-digit updates: digits past 3 leave the frame alone instead of wrapping round to 0-3
+static void testSevSegDigit() {
+
+    unsigned int frame;
+
+    outputToSevSeg(0x1234, 0);
+    setSevSegDigit(0, 0xA);
+    CHECK((readReg(SEVSEG_DATA_ADDR) & 0x0F0F0F0F) == 0x0102030A);
+
+    frame = readReg(SEVSEG_DATA_ADDR);
+    setSevSegDigit(4, 0x5);
+    setSevSegChar(7, 'E');
+    clearSevSegDigit(255);
+    setSevSegPoint(4, 1);
+    CHECK(readReg(SEVSEG_DATA_ADDR) == frame);
+}
+
+// RGB select: anything nonzero is LED 2, and nothing past its three channels is touched
+static void testRGBSelect() {
+
+    rgbAnimation a;
+    int c;
+
+    outputToRGBFixed(0, 0, 0);
+    outputToRGBFixed(1, 0, 0);
+    writeReg(RGB_WIDTH_BASEADDR + 0x60, 0x5A5A);
+
+    outputToRGBFixed(5, 0xFFFFFF, 0xFFFF);
+    for(c = 0; c < 3; c++) {
+        CHECK(readReg(RGB_WIDTH_BASEADDR + 0x10 * c) == 0);
+        CHECK(readReg(RGB_WIDTH_BASEADDR + 0x10 * c + 0x30) != 0);
+    }
+    CHECK(readReg(RGB_WIDTH_BASEADDR + 0x60) == 0x5A5A);
+
+    outputToRGBFixed(1, 0, 0);
+    animateRGBFade(&a, 2, 0xFFFFFF, 0xFFFFFF, 10, false);
+    tickRGBAnimation(&a, 0);
+    CHECK(readReg(RGB_WIDTH_BASEADDR + 0x30) != 0);
+    CHECK(readReg(RGB_WIDTH_BASEADDR + 0x60) == 0x5A5A);
+}
+
+// RGB animation timing over long periods, where a coarse keyframe rate would fall short
+static void testRGBAnimationLong() {
+
+    const unsigned long ten_min = 600000UL;
+    const unsigned long five_h = 18000000UL;
+    rgbAnimation a;
+    unsigned int full;
+
+    outputToRGBFixed(0, 0xFFFFFF, 0xFFFF);
+    full = readReg(RGB_WIDTH_BASEADDR);
+
+    // the last millisecond of a 10 minute fade is on the final keyframe
+    animateRGBFade(&a, 0, 0x000000, 0xFFFFFF, ten_min, false);
+    CHECK(tickRGBAnimation(&a, 0));
+    CHECK(tickRGBAnimation(&a, ten_min - 1));
+    CHECK(readReg(RGB_WIDTH_BASEADDR) == full);
+
+    // halfway through a 5 hour fade it has moved off the first keyframe
+    animateRGBFade(&a, 0, 0x000000, 0xFFFFFF, five_h, false);
+    tickRGBAnimation(&a, 0);
+    CHECK(readReg(RGB_WIDTH_BASEADDR) == 0);
+    tickRGBAnimation(&a, five_h / 2);
+    CHECK(readReg(RGB_WIDTH_BASEADDR) != 0);
+
+    // no colors to cycle through: finished, and the LED is left alone
+    outputToRGBFixed(0, 0x123456, 0xFFFF);
+    full = readReg(RGB_WIDTH_BASEADDR);
+    animateRGBCycle(&a, 0, NULL, 0, 100);
+    CHECK(!tickRGBAnimation(&a, 0));
+    CHECK(readReg(RGB_WIDTH_BASEADDR) == full);
+}
+
+// Output queue: a burst of commands for one peripheral ends in a single write of the last one
+static void testOutputQueue() {
+
+    outputQueue q;
+    outputQueueStats st;
+    int i;
+
+    initOutputQueue(&q, 0);
+
+    for(i = 1; i <= 1000; i++) {
+        queueLEDs(&q, i);
+    }
+    queueRGB(&q, 1, 0x00FF00, 0xFFFF);
+
+    CHECK(flushOutputQueue(&q) == 2);
+    CHECK(readReg(LED_ADDR) == 1000);
+    CHECK(flushOutputQueue(&q) == 0); // nothing new since
+
+    getOutputQueueStats(&q, &st);
+    CHECK(st.submitted == 1001);
+    CHECK(st.written == 2);
+    CHECK(st.coalesced == 999);
+    CHECK(st.pending == 0);
+
+    // pending again after the flush, and stopOutputThread() still writes it
+    queueLEDs(&q, 0x155);
+    stopOutputThread(&q);
+    CHECK(readReg(LED_ADDR) == 0x155);
+}
+
+// Display sink: a producer that slows down after a burst gets every value rendered
+static void testDisplaySink() {
+
+    displaySink d;
+    unsigned long submitted, rendered;
+    int i;
+
+    initDisplaySink(&d, 60);
+
+    for(i = 0; i < 100000; i++) {
+        sinkLEDs(&d, i & 0x3FF);
+    }
+
+    // 20 Hz is well under the 60 Hz cap, so each one is due when it arrives
+    for(i = 0; i < 10; i++) {
+        delayNs(50000000);
+        CHECK(sinkLEDs(&d, i));
+        CHECK(readReg(LED_ADDR) == (unsigned int)i);
+    }
+
+    getDisplaySinkStats(&d, &submitted, &rendered);
+    CHECK(submitted == 100010);
+    CHECK(rendered < 100);
+}
+
+#ifdef __linux__
+// waitForInput() on an eventfd standing in for the UIO interrupts
+static void testInputEventFd() {
+
+    const int fd = eventfd(0, 0);
+    const unsigned long long buttons = INPUT_SOURCE_BUTTONS;
+    const unsigned long long switches = INPUT_SOURCE_SWITCHES;
+    const unsigned long long both = INPUT_SOURCE_BUTTONS | INPUT_SOURCE_SWITCHES;
+    unsigned long long start;
+
+    CHECK(fd >= 0);
+    if(fd < 0) {
+        return;
+    }
+    setInputEventFd(fd);
+
+    // nothing fired: times out after about 20 ms
+    start = getNanos();
+    CHECK(waitForInput(20) == 0);
+    CHECK(getNanos() - start >= 15000000ULL);
+
+    CHECK(write(fd, &switches, sizeof(switches)) == sizeof(switches));
+    CHECK(waitForInput(1000) == INPUT_SOURCE_SWITCHES);
+
+    CHECK(write(fd, &buttons, sizeof(buttons)) == sizeof(buttons));
+    CHECK(waitForInput(1000) == INPUT_SOURCE_BUTTONS);
+
+    CHECK(write(fd, &both, sizeof(both)) == sizeof(both));
+    CHECK(waitForInput(1000) == (INPUT_SOURCE_BUTTONS | INPUT_SOURCE_SWITCHES));
+
+    // the counter was consumed, so the next wait times out again
+    CHECK(waitForInput(0) == 0);
+
+    setInputEventFd(-1);
+    close(fd);
+}
+#endif
+
+int main() {
+
+    if(initKlibIo(KLIB_BACKEND_SIM) != 0) {
+        fprintf(stderr, "klib-io-test: could not set up the simulated backend\n");
+        return 1;
+    }
+
+    testSpiLoopback();
+    testI2cSlave();
+    testInputEngine();
+    testSevSegDigit();
+    testRGBSelect();
+    testRGBAnimationLong();
+    testOutputQueue();
+    testDisplaySink();
+#ifdef __linux__
+    testUartLoopback();
+    testInputEventFd();
+#endif
+
+    closeKlibIo();
+
+    printf("klib-io-test: %u checks, %u failed\n", test_checks, test_failures);
+
+    return test_failures != 0;
+}
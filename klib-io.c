@@ -4,19 +4,38 @@
 								Klib-io (for RealDigital Blackboard)
         
         Version:                
-								1.1.2 (Source file)
+								1.2.0 (Source file)
 
         Contributor(s):         
 								Koby Miller
                                 Dr. Jacob Murray
 
         Date last modified:     
-								February 15th, 2024
+								October 17th, 2026
 
 +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
 
+#define _FILE_OFFSET_BITS 64 // peripheral addresses above 2GB must fit in off_t for mmap()
+#define _POSIX_C_SOURCE 200809L // clock_gettime(), CLOCK_MONOTONIC and friends under -std=c11
+
+#define KLIB_IO_LIBRARY_SOURCE // the library always builds its out-of-line versions, even with KLIB_IO_INLINE
+
 #include "klib-io.h"
-#include <sys/_intsup.h>
+#include <stdio.h>
+#include <string.h>
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#elif defined(__SSSE3__)
+    #include <tmmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+#endif
+#ifdef __linux__
+    #include <fcntl.h>
+    #include <poll.h>
+    #include <sched.h>
+    #include <sys/mman.h>
+#endif
 
 /* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
         bitIndex();
@@ -81,529 +100,5010 @@ int intPow(int num,int power) {
 }
 
 /* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-        getButtonStates();
-            
-            Returns button states as a 4-bit binary number
-            
-            Each digit corresponds to 1 of 4 buttons
+        getMillis();
+
+            Returns a monotonic millisecond count, for the tick functions
+            of the non-blocking engines (e.g. tickMarquee())
             
-        Written by Koby Miller
-        Last modified: January 30th, 2024
+        Last modified: October 17th, 2026
 +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
-unsigned int getButtonStates() {
-
-	unsigned int button_states = 0;
+unsigned long getMillis() {
 
-    // read memory address of buttons
-	button_states = *((unsigned int *)BUTTONS_ADDR);
+    struct timespec ts;
 
-	// bitwise-and to check with 4 digits for 4 buttons
-    button_states &= 0b1111;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
 
-	return button_states;
-}//end getButtonStates()
+    return (unsigned long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}//end getMillis()
 
 /* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-        getSwitchStates();
-            
-            Returns switch states as a 12-bit binary number
-            
-            Each digit corresponds to 1 of 12 buttons
-            
-        Written by Koby Miller
-        Last modified: January 30th, 2024
+        Register access backend
+
+            Every peripheral window is mapped once by initKlibIo() and its
+            base pointer is cached in klib_window_base[]. klibReg() turns a
+            physical address into a pointer inside the right window; with a
+            constant address the window lookup folds away at compile time.
+
+            The table starts out holding the physical addresses themselves,
+            so bare-metal code that never calls initKlibIo() keeps working.
 +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
-unsigned int getSwitchStates() {
+static const unsigned int klib_window_addr[KLIB_WINDOW_COUNT] = {
+    BUTTONS_ADDR, LED_ADDR, SWITCHES_ADDR, RGB_EN_BASEADDR, SEVSEG_CTRL_ADDR, GPIO_PS_BASEADDR
+};
 
-	unsigned int switch_states = 0;
+static volatile unsigned int *klib_window_base[KLIB_WINDOW_COUNT] = {
+    (volatile unsigned int *)(unsigned long)BUTTONS_ADDR,
+    (volatile unsigned int *)(unsigned long)LED_ADDR,
+    (volatile unsigned int *)(unsigned long)SWITCHES_ADDR,
+    (volatile unsigned int *)(unsigned long)RGB_EN_BASEADDR,
+    (volatile unsigned int *)(unsigned long)SEVSEG_CTRL_ADDR,
+    (volatile unsigned int *)(unsigned long)GPIO_PS_BASEADDR
+};
 
-    // read memory address of switches
-	switch_states = *((unsigned int *)SWITCHES_ADDR);
+static int klib_window_fd[KLIB_WINDOW_COUNT] = {-1, -1, -1, -1, -1, -1}; // open /dev/uioN per window (UIO only)
+static byte klib_backend = KLIB_BACKEND_BAREMETAL;
+static unsigned int *klib_sim_regs = NULL; // simulated register file (SIM only)
+#ifdef __linux__
+static volatile unsigned int *klib_gtimer = NULL; // global timer counter, NULL while getNanos() uses clock_gettime()
+#define GTIMER_CHECK_NS 10000 // a running global timer moves by thousands of ticks in this time
+#else
+static volatile unsigned int *klib_gtimer = (volatile unsigned int *)GTIMER_COUNT_LO;
+#endif
 
-	// bitwise-and to check with 12 digits for 12 buttons
-    switch_states &= 0b111111111111;
+// Index of the window holding 'addr', KLIB_WINDOW_COUNT if none does
+static inline int klibWindow(unsigned int addr) {
 
-	return switch_states;
-}//end getSwitchStates()
+    switch(addr & ~(KLIB_WINDOW_SIZE - 1)) {
+        case BUTTONS_ADDR:      return KLIB_WINDOW_BUTTONS;
+        case LED_ADDR:          return KLIB_WINDOW_LEDS;
+        case SWITCHES_ADDR:     return KLIB_WINDOW_SWITCHES;
+        case RGB_EN_BASEADDR:   return KLIB_WINDOW_RGB;
+        case SEVSEG_CTRL_ADDR:  return KLIB_WINDOW_SEVSEG;
+        case GPIO_PS_BASEADDR:  return KLIB_WINDOW_GPIO_PS;
+        default:                return KLIB_WINDOW_COUNT;
+    }
+}
 
-/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-        enableSevSeg();
-		
-        unsigned int mode       Determines whether the display operates in 'custom' or 'default' mode
-            
-            Used to enable the seven-segment display
-            in either custom or default mode
+// Pointer to the register at physical address 'addr' (must be inside a window)
+static inline volatile unsigned int *klibReg(unsigned int addr) {
+    return klib_window_base[klibWindow(addr)] + ((addr & (KLIB_WINDOW_SIZE - 1)) >> 2);
+}
 
-            0 for default, 1 for custom
-            
-        Written by Koby Miller
-        Last modified: February 9th, 2024
-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
-void enableSevSeg(unsigned int mode) {
-    
-    // if mode is set to 1, enable custom mode, else, leave it off
-    // 1st bit enables, 2nd bit determines mode
-    if(mode == 1) {
-        *((unsigned int *)SEVSEG_CTRL_ADDR) = 0b11;
+// Bus access counters (see getMmioCounts()), compiled out unless KLIB_IO_COUNT_MMIO is defined
+#ifdef KLIB_IO_COUNT_MMIO
+static unsigned long klib_mmio_reads = 0;
+static unsigned long klib_mmio_writes = 0;
+    #define mmioCountReads(n) (klib_mmio_reads += (n))
+    #define mmioCountWrites(n) (klib_mmio_writes += (n))
+#else
+    #define mmioCountReads(n) ((void)0)
+    #define mmioCountWrites(n) ((void)0)
+#endif
+
+// Per-register counters and trace ring (see dumpMmioSummary()), compiled out unless KLIB_IO_TRACE is defined
+#ifdef KLIB_IO_TRACE
+#define KLIB_TRACE_REGS (KLIB_WINDOW_SIZE / 4) // registers per window
+
+static atomic_ulong klib_trace_reads[KLIB_WINDOW_COUNT][KLIB_TRACE_REGS];
+static atomic_ulong klib_trace_writes[KLIB_WINDOW_COUNT][KLIB_TRACE_REGS];
+static atomic_ulong klib_trace_redundant[KLIB_WINDOW_COUNT][KLIB_TRACE_REGS];
+static atomic_uint klib_trace_last[KLIB_WINDOW_COUNT][KLIB_TRACE_REGS]; // last value stored
+static mmioTraceRecord klib_trace_ring[KLIB_TRACE_SIZE];
+static atomic_uint klib_trace_head; // total records ever claimed
+static unsigned long long klib_trace_start = 0; // getNanos() time of the last reset
+
+// Counts 'n' accesses of type 'op' to 'addr' and appends one record to the ring
+static void mmioTrace(unsigned int addr, unsigned int value, byte op, unsigned long n) {
+
+    const int w = klibWindow(addr);
+    const unsigned int r = (addr & (KLIB_WINDOW_SIZE - 1)) >> 2;
+    const unsigned int slot = atomic_fetch_add_explicit(&klib_trace_head, 1, memory_order_relaxed) & (KLIB_TRACE_SIZE - 1);
+
+    if(op == KLIB_TRACE_READ || op == KLIB_TRACE_BURST_READ) {
+        atomic_fetch_add_explicit(&klib_trace_reads[w][r], n, memory_order_relaxed);
     } else {
-        *((unsigned int *)SEVSEG_CTRL_ADDR) = 0b01;
+        // a store of the value already there is one the shadow registers could have skipped
+        if(atomic_fetch_add_explicit(&klib_trace_writes[w][r], n, memory_order_relaxed) != 0 &&
+           op == KLIB_TRACE_WRITE && atomic_load_explicit(&klib_trace_last[w][r], memory_order_relaxed) == value) {
+            atomic_fetch_add_explicit(&klib_trace_redundant[w][r], 1, memory_order_relaxed);
+        }
+        atomic_store_explicit(&klib_trace_last[w][r], value, memory_order_relaxed);
     }
 
+    klib_trace_ring[slot].ns = getNanos();
+    klib_trace_ring[slot].addr = addr;
+    klib_trace_ring[slot].value = value;
+    klib_trace_ring[slot].op = op;
+
     return;
-}//end enableSevSeg()
+}
+    #define mmioTraceAccess(addr, value, op, n) mmioTrace((addr), (value), (op), (n))
+#else
+    #define mmioTraceAccess(addr, value, op, n) ((void)0)
+#endif
+
+// Every library load of a register goes through here
+static inline unsigned int mmioRead(unsigned int addr) {
+
+    const unsigned int val = *klibReg(addr);
+
+    mmioCountReads(1);
+    mmioTraceAccess(addr, val, KLIB_TRACE_READ, 1);
+
+    return val;
+}
+
+// Every library store to a register goes through here
+static inline void mmioWrite(unsigned int addr, unsigned int val) {
+
+    mmioCountWrites(1);
+    mmioTraceAccess(addr, val, KLIB_TRACE_WRITE, 1);
+
+    *klibReg(addr) = val;
+}
+
+// Hot loops that cache a register pointer account for their 'n' accesses in one go
+#define mmioBurstRead(addr, n) do { mmioCountReads(n); mmioTraceAccess((addr), (unsigned int)(n), KLIB_TRACE_BURST_READ, (n)); } while(0)
+#define mmioBurstWrite(addr, n) do { mmioCountWrites(n); mmioTraceAccess((addr), (unsigned int)(n), KLIB_TRACE_BURST_WRITE, (n)); } while(0)
 
 /* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-        outputToSevSeg();
-		
-        int val                 Value to push to the seven-segment display
-        byte mode               Display mode. 0-hexadecimal, 1-decimal, 2-binary
-            
-            Used to display data on the seven-segment display
-            
-        Written by Koby Miller
-        Last modified: February 14th, 2024
+        Shadow registers
+
+            A copy of every writable register the library drives (LEDs,
+            seven-segment ctrl/data, RGB enable/period/width, DIR_2/OE_2).
+            shadowWrite() skips the bus store when the register already holds
+            the value, and shadowRead() serves read-modify-write sequences
+            without touching the bus. A slot is only trusted after it has been
+            written or read once, so the first access always goes to hardware.
+
+            DATA_2 is left out on purpose: PMOD writes go through the
+            MASK_DATA_2_LSW register and never need its current value.
 +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
-void outputToSevSeg(int val, byte mode) {
-    
-    enableSevSeg(0); // ensure sev-seg is in number mode
+#define KLIB_SHADOW_COUNT 23
 
-    unsigned int disp = 0;
-    byte c;
+static unsigned int klib_shadow[KLIB_SHADOW_COUNT];
+static bool klib_shadow_known[KLIB_SHADOW_COUNT]; // slot was written or read once; a byte each, so peripherals never share a word
+static unsigned long klib_shadow_hits = 0;
+static unsigned long klib_shadow_misses = 0;
+static byte klib_pmod_dir[2] = {2, 2}; // direction setupPmod() last gave each PMOD B row, 2 if unknown
 
-    switch(mode) {
-        default:
-        case 0: //hexadecimal
-            
-            for(c = 0; c < 4; c++)
-            {
-                disp |= (val & 0xF) << (c * 8); // Shift over bits based on digit of display
-                val >>= 4; // Shift out least significant digit (divide by 2^4)
-            }
-            
-            break;
-        
-        case 1: //decimal
-        
-            for(c = 0; c < 4;c++) {
-                disp |= (val % 10) << (c * 8); // Extract and store ones digit to temporary variable
-                val = val / 10;    // Remove ones digit
+// Simulated PMOD B wiring, see simPmodConnect()
+static uint8_t klib_sim_wire[8] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}; // pin driving each pin, 0xFF for none
+static bool klib_sim_wired = false;
+
+// Simulated I2C slave on the PMOD B wires, see simPmodI2cSlave()
+#define SIM_I2C_BYTES 16 // data bytes kept for simPmodI2cReceived()
+static struct {
+    uint8_t scl, sda;           // PMOD B pins, 0xFF without a slave
+    uint8_t addr;               // 7-bit address it answers to
+    bool scl_prev, sda_prev;    // bus levels at the previous update
+    int bit;                    // bits clocked into 'shift', 9 during the ACK clock, -1 when idle
+    uint8_t shift;
+    bool first;                 // next byte is the address byte
+    bool ours;                  // this transfer is addressed to the slave
+    bool reading;               // the master reads, only the address is acknowledged
+    bool ack;                   // pulling SDA low
+    uint8_t rx[SIM_I2C_BYTES];
+    size_t count;
+} klib_sim_i2c = {.scl = 0xFF, .sda = 0xFF, .bit = -1};
+
+// Shadow slot of 'addr', -1 if the register is not shadowed
+static inline int shadowSlot(unsigned int addr) {
+
+    unsigned int offset = addr & (KLIB_WINDOW_SIZE - 1);
+
+    switch(klibWindow(addr)) {
+        case KLIB_WINDOW_LEDS:
+            return (offset == 0) ? 0 : -1;
+
+        case KLIB_WINDOW_SEVSEG: // ctrl -> 1, data -> 2
+            return (offset <= 0x4) ? 1 + (int)(offset >> 2) : -1;
+
+        case KLIB_WINDOW_RGB: // 6 channels of 0x10, each holding enable, period, width
+            if(offset >= 0x60 || (offset & 0xC) == 0xC) {
+                return -1;
             }
-            
-            break;
-        case 2: //binary
-            
-            for(c = 0; c < 4; c++)
-            {
-                disp |= (val & 1) << (c * 8); // Shift over bits based on digit of display
-                val >>= 1; // Shift out least significant digit (divide by 2^4)
+            return 3 + (offset >> 4) * 3 + ((offset >> 2) & 0x3);
+
+        case KLIB_WINDOW_GPIO_PS:
+            switch(addr) {
+                case DIR_2:  return 21;
+                case OE_2:   return 22;
+                default:     return -1;
             }
-            
-            break;
+
+        default:
+            return -1;
     }
-    
-    // Turn of decimal points
-    disp |= 0x80808080;
+}
 
-    // Write data to display data memory address
-    *((unsigned int *)SEVSEG_DATA_ADDR) = disp;
-            
-    return;
-}//end outputToSevSeg()
+// Stores 'val' unless the shadow says the register already holds it
+static inline void shadowWrite(unsigned int addr, unsigned int val) {
 
-/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-        outputToSevSegCustom();
-		
-        const char* str         Input string, only first 4 characters are used    
-            
-            Used to display strings on the seven-segment display
-            Any non-supported character will be blank. If a letter is only available
-            in either upper or lower case, both upper and lower case inputs will 
-            use the only available one.
-            
-        Written by Koby Miller
-        Last modified: February 14th, 2024
-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
-void outputToSevSegCustom(const char* str) {
-    
-    enableSevSeg(1); // ensure sev-seg is in custom mode
+    const int s = shadowSlot(addr);
 
-    unsigned int disp = 0; // what will be displayed
-    unsigned int temp = 0; // stores what character to shift into sev-seg
-    byte c; // iterator
+    if(s < 0) { // folds away for the constant addresses every caller passes
+        mmioWrite(addr, val);
+        return;
+    }
 
-                                                                                                                // [!] big long nasty switch-case comin' up [!]
-    
-    for(c = 0;c < 4;c++) {
-        // Determine how to display indexed letter on sev-seg
-        switch(str[c]) {                                                                                        // minimize this line ~
-            case 'A':
-            case 'a':
-                temp = SEVSEG_CHAR_A;
-                break;
+    if(klib_shadow_known[s] && klib_shadow[s] == val) {
+        klib_shadow_hits++;
+        return;
+    }
 
-            case 'B':
-            case 'b':
-                temp = SEVSEG_CHAR_B;
-                break;
+    klib_shadow_misses++;
+    klib_shadow[s] = val;
+    klib_shadow_known[s] = true;
+    mmioWrite(addr, val);
 
-            case 'C':
-                temp = SEVSEG_CHAR_C;
-                break;
+    return;
+}
 
-            case 'c':
-                temp = SEVSEG_CHAR_c;
-                break;
+// Returns the register value, from the shadow when it is known
+static inline unsigned int shadowRead(unsigned int addr) {
 
-            case 'D':
-            case 'd':
-                temp = SEVSEG_CHAR_D;
-                break;
+    const int s = shadowSlot(addr);
 
-            case 'E':
-            case 'e':
-                temp = SEVSEG_CHAR_E;
-                break;
+    if(s < 0) {
+        return mmioRead(addr);
+    }
 
-            case 'F':
-            case 'f':
-                temp = SEVSEG_CHAR_F;
-                break;
+    if(klib_shadow_known[s]) {
+        klib_shadow_hits++;
+        return klib_shadow[s];
+    }
 
-            case 'G':
-                temp = SEVSEG_CHAR_G;
-                break;
+    klib_shadow_misses++;
+    klib_shadow[s] = mmioRead(addr);
+    klib_shadow_known[s] = true;
 
-            case 'g':
-                temp = SEVSEG_CHAR_g;
-                break;
+    return klib_shadow[s];
+}
 
-            case 'H':
-                temp = SEVSEG_CHAR_H;
-                break;
+// Per-peripheral locks (see lockPeripheral()), compiled out unless KLIB_IO_THREADSAFE is defined
+#ifdef KLIB_IO_THREADSAFE
+#define KLIB_LOCK_SPINS 64 // failed attempts before yielding the CPU
 
-            case 'h':
-                temp = SEVSEG_CHAR_h;
-                break;
+// Recursive spinlock, 'owner' is the address of the holder's klib_thread_tag
+static struct {
+    atomic_uintptr_t owner;
+    unsigned int depth;         // only touched by the owner
+    char pad[64 - sizeof(atomic_uintptr_t) - sizeof(unsigned int)]; // one cache line each
+} klib_locks[KLIB_PERIPH_COUNT];
+static _Thread_local char klib_thread_tag;
 
-            case 'I':
-                temp = SEVSEG_CHAR_I;
-                break;
+static void periphLock(int p) {
 
-            case 'i':
-                temp = SEVSEG_CHAR_i;
-                break;
+    const uintptr_t me = (uintptr_t)&klib_thread_tag;
+    uintptr_t expected;
+    unsigned int spins = 0;
 
-            case 'J':
-            case 'j':
-                temp = SEVSEG_CHAR_J;
-                break;
+    if(p < 0) {
+        return;
+    }
 
-            case 'L':
-                temp = SEVSEG_CHAR_L;
-                break;
+    if(atomic_load_explicit(&klib_locks[p].owner, memory_order_relaxed) == me) {
+        klib_locks[p].depth++;
+        return;
+    }
 
-            case 'l':
-                temp = SEVSEG_CHAR_l;
-                break;
+    for(;;) {
+        expected = 0;
+        if(atomic_compare_exchange_weak_explicit(&klib_locks[p].owner, &expected, me,
+                                                 memory_order_acquire, memory_order_relaxed)) {
+            break;
+        }
+        if(++spins >= KLIB_LOCK_SPINS) {
+            spins = 0;
+#ifdef __linux__
+            sched_yield();
+#endif
+        }
+    }
+    klib_locks[p].depth = 1;
 
-            case 'N':
-                temp = SEVSEG_CHAR_N;
-                break;
+    return;
+}
 
-            case 'n':
-                temp = SEVSEG_CHAR_n;
-                break;
+static void periphUnlock(int p) {
 
-            case 'O':
-                temp = SEVSEG_CHAR_O;
-                break;
+    if(p < 0) {
+        return;
+    }
 
-            case 'o':
-                temp = SEVSEG_CHAR_o;
-                break;
+    if(--klib_locks[p].depth == 0) {
+        atomic_store_explicit(&klib_locks[p].owner, 0, memory_order_release);
+    }
 
-            case 'P':
-            case 'p':
-                temp = SEVSEG_CHAR_P;
-                break;
+    return;
+}
+#else
+    #define periphLock(p) ((void)(p))
+    #define periphUnlock(p) ((void)(p))
+#endif
 
-            case 'Q':
-            case 'q':
-                temp = SEVSEG_CHAR_Q;
-                break;
+// Peripheral lock guarding 'addr', -1 for registers the library never modifies
+static inline int periphOf(unsigned int addr) {
 
-            case 'R':
-            case 'r':
-                temp = SEVSEG_CHAR_R;
-                break;
+    switch(klibWindow(addr)) {
+        case KLIB_WINDOW_LEDS:      return KLIB_PERIPH_LEDS;
+        case KLIB_WINDOW_SEVSEG:    return KLIB_PERIPH_SEVSEG;
+        case KLIB_WINDOW_RGB:       return ((addr & (KLIB_WINDOW_SIZE - 1)) < 0x30) ? KLIB_PERIPH_RGB1 : KLIB_PERIPH_RGB2;
+        case KLIB_WINDOW_GPIO_PS:   return KLIB_PERIPH_PMOD;
+        default:                    return -1;
+    }
+}
 
-            case 'S':
-            case 's':
-                temp = SEVSEG_CHAR_S;
-                break;
+// Claims every display peripheral, for the board frame functions
+static inline void lockBoard() {
 
-            case 'T':
-            case 't':
-                temp = SEVSEG_CHAR_T;
-                break;
+    periphLock(KLIB_PERIPH_LEDS);
+    periphLock(KLIB_PERIPH_SEVSEG);
+    periphLock(KLIB_PERIPH_RGB1);
+    periphLock(KLIB_PERIPH_RGB2);
 
-            case 'U':
-                temp = SEVSEG_CHAR_U;
-                break;
+    return;
+}
 
-            case 'u':
-                temp = SEVSEG_CHAR_u;
-                break;
+static inline void unlockBoard() {
 
-            case 'Y':
-            case 'y':
-                temp = SEVSEG_CHAR_Y;
-                break;
-                
-            case '1':
-                temp = SEVSEG_CHAR_1;
-                break;
-                
-            case '2':
-                temp = SEVSEG_CHAR_2;
-                break;
-                
-            case '3':
-                temp = SEVSEG_CHAR_3;
-                break;
-                
-            case '4':
-                temp = SEVSEG_CHAR_4;
-                break;
-                
-            case '5':
-                temp = SEVSEG_CHAR_5;
-                break;
-                
-            case '6':
-                temp = SEVSEG_CHAR_6;
-                break;
-                
-            case '7':
-                temp = SEVSEG_CHAR_7;
-                break;
-                
-            case '8':
-                temp = SEVSEG_CHAR_8;
-                break;
-                
-            case '9':
-                temp = SEVSEG_CHAR_9;
-                break;
-                
-            case '0':
-                temp = SEVSEG_CHAR_0;
-                break;
-                
-            case '-':
-                temp = SEVSEG_CHAR_DASH;
-                break;
-                
-            case '=':
-                temp = SEVSEG_CHAR_EQUAL;
-                break;
-                
-            case '_':
-                temp = SEVSEG_CHAR_UNDERSCORE;
-                break;
+    periphUnlock(KLIB_PERIPH_RGB2);
+    periphUnlock(KLIB_PERIPH_RGB1);
+    periphUnlock(KLIB_PERIPH_SEVSEG);
+    periphUnlock(KLIB_PERIPH_LEDS);
 
-            default:
-                temp = SEVSEG_CHAR_BLANK;
-                break;
+    return;
+}
+
+#ifdef __linux__
+// Finds the /dev/uioN whose first map starts at 'phys', returns its number or -1
+static int findUio(unsigned int phys) {
+
+    char path[64];
+    unsigned long addr = 0;
+    FILE *f;
+    int n;
+
+    for(n = 0; n < 64; n++) {
+        snprintf(path, sizeof(path), "/sys/class/uio/uio%d/maps/map0/addr", n);
+        f = fopen(path, "r");
+        if(f == NULL) {
+            continue;
+        }
+        if(fscanf(f, "%lx", &addr) != 1) {
+            addr = 0;
+        }
+        fclose(f);
+        if(addr == phys) {
+            return n;
         }
-        disp |= temp << (24 - c * 8);
     }
-    
-    // Disable decimal points
-    disp |= 0x80808080;
-    
-    // Send display data to display memory address
-    *((unsigned int *)SEVSEG_DATA_ADDR) = disp;
 
-    return;
-}//end outputToSevSegCustom()
+    return -1;
+}
+#endif
 
 /* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-        outputToLEDs();
-		
-        int val       Value to push to the LEDs
-            
-            Used to display data on LEDs
+        closeKlibIo();
+
+            Unmaps every peripheral window (or frees the simulated register
+            file) and returns to the bare-metal backend
             
-        Written by Koby Miller
-        Last modified: January 30th, 2024
+        Last modified: October 17th, 2026
 +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
-void outputToLEDs(int val) {
-    
-    // Where LEDs overlap with '1' bits
-    val &= 0b1111111111;
+void closeKlibIo() {
+
+    int w;
+
+    for(w = 0; w < KLIB_WINDOW_COUNT; w++) {
+#ifdef __linux__
+        if((klib_backend == KLIB_BACKEND_DEVMEM || klib_backend == KLIB_BACKEND_UIO) &&
+            klib_window_base[w] != (volatile unsigned int *)MAP_FAILED) {
+            munmap((void *)klib_window_base[w], KLIB_WINDOW_SIZE);
+        }
+        if(klib_window_fd[w] >= 0) {
+            close(klib_window_fd[w]);
+        }
+#endif
+        klib_window_fd[w] = -1;
+        klib_window_base[w] = (volatile unsigned int *)(unsigned long)klib_window_addr[w];
+    }
+
+#ifdef __linux__
+    if(klib_gtimer != NULL) {
+        munmap((void *)(klib_gtimer - (GTIMER_COUNT_LO - GTIMER_PAGE) / 4), KLIB_WINDOW_SIZE);
+        klib_gtimer = NULL;
+    }
+#endif
+
+    free(klib_sim_regs);
+    klib_sim_regs = NULL;
+    klib_backend = KLIB_BACKEND_BAREMETAL;
+    memset(klib_shadow_known, 0, sizeof(klib_shadow_known)); // a different backend means different registers
+    klib_pmod_dir[0] = 2;
+    klib_pmod_dir[1] = 2;
+    memset(klib_sim_wire, 0xFF, sizeof(klib_sim_wire));
+    klib_sim_wired = false;
+    klib_sim_i2c.scl = 0xFF;
+    klib_sim_i2c.sda = 0xFF;
 
-    // Write to LEDs' address
-	*((unsigned int *)LED_ADDR) = val;
-    
     return;
-}//end outputToLEDs()
+}//end closeKlibIo()
 
 /* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-        enableRGB();
+        initKlibIo();
+		
+        byte backend            KLIB_BACKEND_BAREMETAL, _DEVMEM, _UIO or _SIM
 
-        unsigned int select     Binary number to enable each LED    
+            Maps every peripheral window once and caches the base pointers,
+            so each register access afterwards is a single load or store.
+            Calling it again switches backends.
 
-            Used to enable RGB LEDs.
-            enableRGB(0b11) enables both LEDs
-            enableRGB(0b10) enables only second LED
+            Returns 0 on success, -1 on failure (bare-metal is left selected).
             
-        Written by Koby Miller
-        Last modified: February 14th, 2024
+        Last modified: October 17th, 2026
 +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
-void enableRGB(unsigned int select) {
-    
-    unsigned int rgb[2] = {bitIndex(select,0),bitIndex(select,1)}; //create array regarding the bit values of 'select' variable
-    byte c = 0; //iterator
+int initKlibIo(byte backend) {
 
-    for(c = 0; c < 3;c++) {
-        *((unsigned int *)(RGB_EN_BASEADDR + c * 0x10)) = rgb[0]; 
+    int w;
+
+    closeKlibIo(); // drop whatever was mapped before
+    resetMmioCounts();
+
+    switch(backend) {
+        case KLIB_BACKEND_BAREMETAL:
+            calibrateTiming();
+            return 0;
+
+        case KLIB_BACKEND_SIM:
+            // one zeroed block, carved into a window each
+            klib_sim_regs = calloc(KLIB_WINDOW_COUNT, KLIB_WINDOW_SIZE);
+            if(klib_sim_regs == NULL) {
+                return -1;
+            }
+            for(w = 0; w < KLIB_WINDOW_COUNT; w++) {
+                klib_window_base[w] = klib_sim_regs + w * (KLIB_WINDOW_SIZE / sizeof(unsigned int));
+            }
+            klib_backend = KLIB_BACKEND_SIM;
+            calibrateTiming();
+            return 0;
+
+#ifdef __linux__
+        case KLIB_BACKEND_DEVMEM:
+        case KLIB_BACKEND_UIO: {
+            char path[32];
+            void *map;
+            volatile unsigned int *count;
+            unsigned long long start;
+            unsigned int first;
+            int fd = -1;
+            int uio;
+
+            if(backend == KLIB_BACKEND_DEVMEM) {
+                fd = open("/dev/mem", O_RDWR | O_SYNC);
+                if(fd < 0) {
+                    return -1;
+                }
+            }
+
+            klib_backend = backend;
+            for(w = 0; w < KLIB_WINDOW_COUNT; w++) {
+                if(backend == KLIB_BACKEND_DEVMEM) {
+                    map = mmap(NULL, KLIB_WINDOW_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, klib_window_addr[w]);
+                } else {
+                    uio = findUio(klib_window_addr[w]);
+                    if(uio >= 0) {
+                        snprintf(path, sizeof(path), "/dev/uio%d", uio);
+                        klib_window_fd[w] = open(path, O_RDWR | O_SYNC);
+                    }
+                    // map0 of a UIO device lives at offset 0
+                    map = (klib_window_fd[w] < 0) ? MAP_FAILED :
+                        mmap(NULL, KLIB_WINDOW_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, klib_window_fd[w], 0);
+                }
+
+                if(map == MAP_FAILED) {
+                    break;
+                }
+                klib_window_base[w] = map;
+            }
+
+            // the global timer has no UIO device, and getNanos() falls back to clock_gettime() without it
+            if(fd >= 0 && w == KLIB_WINDOW_COUNT) {
+                map = mmap(NULL, KLIB_WINDOW_SIZE, PROT_READ, MAP_SHARED, fd, GTIMER_PAGE);
+                if(map != MAP_FAILED) {
+                    count = (volatile unsigned int *)map + (GTIMER_COUNT_LO - GTIMER_PAGE) / 4;
+
+                    // a stopped counter would hang every spin wait, it has to move within GTIMER_CHECK_NS
+                    first = count[0];
+                    start = getNanos(); // still clock_gettime() here
+                    while(count[0] == first && getNanos() - start < GTIMER_CHECK_NS) {
+                    }
+
+                    if(count[0] != first) {
+                        klib_gtimer = count;
+                    } else {
+                        munmap(map, KLIB_WINDOW_SIZE);
+                    }
+                }
+            }
+
+            if(fd >= 0) {
+                close(fd); // mappings stay valid after the descriptor is closed
+            }
+
+            if(w < KLIB_WINDOW_COUNT) {
+                // mark the windows that never got mapped so closeKlibIo() skips them
+                for(; w < KLIB_WINDOW_COUNT; w++) {
+                    klib_window_base[w] = (volatile unsigned int *)MAP_FAILED;
+                }
+                closeKlibIo();
+                return -1;
+            }
+            calibrateTiming();
+            return 0;
+        }
+#endif
+
+        default:
+            return -1;
     }
-    
-    for(c = 0; c < 3;c++) {
-        *((unsigned int *)(RGB_EN_BASEADDR + c * 0x10 + 0x30)) = rgb[1];
+}//end initKlibIo()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        readReg();
+		
+        unsigned int addr       Physical address of the register (e.g. LED_ADDR)
+
+            Reads a register through the active backend.
+            Addresses outside the mapped windows read as 0.
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+unsigned int readReg(unsigned int addr) {
+
+    if(klibWindow(addr) == KLIB_WINDOW_COUNT) {
+        return 0;
+    }
+
+    return mmioRead(addr);
+}//end readReg()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        writeReg();
+		
+        unsigned int addr       Physical address of the register (e.g. LED_ADDR)
+        unsigned int val        Value to store
+
+            Writes a register through the active backend.
+            Addresses outside the mapped windows are ignored.
+            The store is never elided, but the shadow copy is updated.
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void writeReg(unsigned int addr, unsigned int val) {
+
+    const int s = shadowSlot(addr);
+    const int p = periphOf(addr);
+
+    if(klibWindow(addr) == KLIB_WINDOW_COUNT) {
+        return;
+    }
+
+    // always store, but keep the shadow coherent
+    periphLock(p);
+    if(s >= 0) {
+        klib_shadow[s] = val;
+        klib_shadow_known[s] = true;
     }
+    mmioWrite(addr, val);
+    periphUnlock(p);
 
     return;
-}//end enableRGB()
+}//end writeReg()
 
 /* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-        outputToRGB();
+        modifyReg();
 		
-        unsigned int select         Picks which LED to send to 
-        unsigned int color          HEX color to display
-        float bright                0.0 - 1.0 value to determine brightness of LED
+        unsigned int addr       Physical address of the register (e.g. DIR_2)
+        unsigned int clear      Bits to clear
+        unsigned int set        Bits to set, applied after 'clear'
 
-            Used to display light on RGB LEDs
+            Read-modify-write of one register. With KLIB_IO_THREADSAFE the
+            whole sequence holds the owning peripheral's lock, so two threads
+            changing different bits of the same register never lose an update.
+            Shadowed registers are read from the shadow and the store is
+            skipped when nothing changes.
+            Returns the new register value, 0 outside the mapped windows.
             
-        Written by Koby Miller
-        Last modified: February 14th, 2024
+        Last modified: October 17th, 2026
 +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
-void outputToRGB(unsigned int select, unsigned int color, float bright) {
-    
-    const unsigned int offset = select * 0x30; // offset address based on 'select' variable
-    byte c = 0; // iterator
-    
-    // Mask color off to only valid HEX code
-    color &= 0xFFFFFF;
-    
-    for(c = 0;c < 3;c++) {
-        // Constant period
-        // Offset pointer by 0x10 at a time for each color
-        *(unsigned int*)(RGB_PERIOD_BASEADDR + 0x10 * c + offset) = 2550; 
+unsigned int modifyReg(unsigned int addr, unsigned int clear, unsigned int set) {
 
-        // Change width based on passed color HEX value
-        // Offset pointer by 0x10 at a time for each color
-        // Two least significant digits are blue, next two are green, two most significant are red
-        *(unsigned int*)(RGB_WIDTH_BASEADDR + 0x10 * c + offset) = (unsigned int)(bright * 10 * ((color >> c * 8) % 256));
+    const int p = periphOf(addr);
+    unsigned int val;
+
+    if(klibWindow(addr) == KLIB_WINDOW_COUNT) {
+        return 0;
+    }
+
+    periphLock(p);
+    val = (shadowRead(addr) & ~clear) | set;
+    shadowWrite(addr, val);
+    periphUnlock(p);
+
+    return val;
+}//end modifyReg()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        lockPeripheral();
+		
+        byte periph             Peripheral to claim (KLIB_PERIPH_LEDS .. KLIB_PERIPH_PMOD)
+
+            Every library call already locks the peripheral it touches, one
+            lock per peripheral, so threads driving different peripherals
+            never wait on each other. This holds the lock across several
+            calls instead (e.g. a whole I2C transaction sequence, or a
+            setupPmod() + pmodWrite() pair). The locks are recursive, so the
+            owner keeps calling the library as usual. Take several locks in
+            ascending KLIB_PERIPH_* order.
+
+            pmodWriteFast()/pmodReadFast(), the SPI and UART engines and
+            runPmodCapture() take no lock: their pin writes go through
+            MASK_DATA_2_LSW, which the hardware applies atomically per pin.
+            The simulator's PMOD pin model is not thread-safe.
+            Shadow hit/miss statistics are approximate under contention.
+
+            Compiles to nothing without KLIB_IO_THREADSAFE.
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void lockPeripheral(byte periph) {
+
+    if(periph >= 0 && periph < KLIB_PERIPH_COUNT) {
+        periphLock(periph);
     }
 
     return;
-}
+}//end lockPeripheral()
 
 /* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-        setupPmod();
+        unlockPeripheral();
 		
-        bool io             read (0) or write (1)
-        bool row            top (0) or bottom (1) row
+        byte periph             Peripheral to release
 
-            Enables the mode of PMOD B
-        
-        Written by Koby Miller
-        Originally written by Dr. Jacob Murray
-        Last modified: February 9th, 2024
+            Releases one lockPeripheral() claim by the calling thread.
+            
+        Last modified: October 17th, 2026
 +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
-void setupPmod(bool io, bool row) {
+void unlockPeripheral(byte periph) {
 
-    if(row == 0) {
-        if(io == 0) {   // bits 7-10 of DIR_2 for top row should be 0000 for input
-            *((unsigned int*)DIR_2) &= ~PMODB_TOP_MASK;
-            *((unsigned int*)OE_2) &= ~PMODB_TOP_MASK;
+    if(periph >= 0 && periph < KLIB_PERIPH_COUNT) {
+        periphUnlock(periph);
+    }
 
-        } else {        // bits 7-10 of DIR_2 for top row should be 1111 for output
-            *((unsigned int*)DIR_2) |= PMODB_TOP_MASK;
-            *((unsigned int*)OE_2) |= PMODB_TOP_MASK;
+    return;
+}//end unlockPeripheral()
 
-        }   
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        invalidateShadow();
 
-    } else {
-        if(io == 0) {   // bits 11-14 of DIR_2 for bopttom row should be 0000 for input
-            *((unsigned int*)DIR_2) &= ~PMODB_BOTTOM_MASK;
-            *((unsigned int*)OE_2) &= ~PMODB_BOTTOM_MASK;
+            Forgets every shadowed register value, so the next access of
+            each goes to the bus. Use after something outside this library
+            (another process, a reset) changed the output registers.
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void invalidateShadow() {
 
-        } else {        // bits 11-14 of DIR_2 for bottom row should be 1111 for output
-            *((unsigned int*)DIR_2) |= PMODB_BOTTOM_MASK;
-            *((unsigned int*)OE_2) |= PMODB_BOTTOM_MASK;
+    int p;
+
+    for(p = 0; p < KLIB_PERIPH_COUNT; p++) {
+        periphLock(p);
+    }
+
+    memset(klib_shadow_known, 0, sizeof(klib_shadow_known));
+    klib_pmod_dir[0] = 2;
+    klib_pmod_dir[1] = 2;
+
+    for(p = KLIB_PERIPH_COUNT - 1; p >= 0; p--) {
+        periphUnlock(p);
+    }
+
+    return;
+}//end invalidateShadow()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        getShadowStats();
+		
+        unsigned long* hits         Accesses served by the shadow (elided stores and cached reads)
+        unsigned long* misses       Accesses that went to the bus
+
+            Either pointer may be NULL. Counters are cleared with resetShadowStats()
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void getShadowStats(unsigned long* hits, unsigned long* misses) {
+
+    if(hits != NULL) {
+        *hits = klib_shadow_hits;
+    }
+    if(misses != NULL) {
+        *misses = klib_shadow_misses;
+    }
+
+    return;
+}//end getShadowStats()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        resetShadowStats();
+
+            Clears the shadow hit/miss counters
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void resetShadowStats() {
+
+    klib_shadow_hits = 0;
+    klib_shadow_misses = 0;
+
+    return;
+}//end resetShadowStats()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        getMmioCounts();
+		
+        unsigned long* reads        Register loads issued by the library
+        unsigned long* writes       Register stores issued by the library
+
+            Bus transaction totals for profiling. They are only counted when
+            the library is built with -DKLIB_IO_COUNT_MMIO, otherwise both
+            stay 0 and the accesses carry no overhead. Either pointer may be NULL.
+        
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void getMmioCounts(unsigned long* reads, unsigned long* writes) {
+
+#ifdef KLIB_IO_COUNT_MMIO
+    if(reads != NULL) {
+        *reads = klib_mmio_reads;
+    }
+    if(writes != NULL) {
+        *writes = klib_mmio_writes;
+    }
+#else
+    if(reads != NULL) {
+        *reads = 0;
+    }
+    if(writes != NULL) {
+        *writes = 0;
+    }
+#endif
+
+    return;
+}//end getMmioCounts()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        resetMmioCounts();
+
+            Clears the bus transaction totals
             
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void resetMmioCounts() {
+
+#ifdef KLIB_IO_TRACE
+    int w, r;
+#endif
+
+#ifdef KLIB_IO_COUNT_MMIO
+    klib_mmio_reads = 0;
+    klib_mmio_writes = 0;
+#endif
+
+#ifdef KLIB_IO_TRACE
+    for(w = 0; w < KLIB_WINDOW_COUNT; w++) {
+        for(r = 0; r < KLIB_TRACE_REGS; r++) {
+            atomic_store_explicit(&klib_trace_reads[w][r], 0, memory_order_relaxed);
+            atomic_store_explicit(&klib_trace_writes[w][r], 0, memory_order_relaxed);
+            atomic_store_explicit(&klib_trace_redundant[w][r], 0, memory_order_relaxed);
         }
     }
+    atomic_store_explicit(&klib_trace_head, 0, memory_order_relaxed);
+    klib_trace_start = getNanos();
+#endif
 
     return;
-}
+}//end resetMmioCounts()
 
 /* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-        pmodRead();
+        readMmioTrace();
 		
-        bool row            top (0) or bottom (1) row
+        mmioTraceRecord* out        Filled with the most recent accesses, oldest first
+        unsigned int max            Room in 'out'
 
-            Returns a 4-bit value from the PMOD B row selected
+            Copies the trace ring (KLIB_IO_TRACE builds only). Producers
+            claim slots with one atomic add and never wait, so a record
+            being written during the copy can come out torn.
+            Returns the number of records copied, 0 without KLIB_IO_TRACE.
         
-        Written by Koby Miller
-        Originally written by Dr. Jacob Murray
-        Last modified: February 9th, 2024
+        Last modified: October 17th, 2026
 +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
-unsigned int pmodRead(bool row) {
+unsigned int readMmioTrace(mmioTraceRecord* out, unsigned int max) {
 
-    unsigned int data = 0;
+#ifdef KLIB_IO_TRACE
+    const unsigned int head = atomic_load_explicit(&klib_trace_head, memory_order_acquire);
+    unsigned int n = (head < KLIB_TRACE_SIZE) ? head : KLIB_TRACE_SIZE;
+    unsigned int i;
 
-    setupPmod(0, row); // ensure input mode
+    if(n > max) {
+        n = max;
+    }
+    for(i = 0; i < n; i++) {
+        out[i] = klib_trace_ring[(head - n + i) & (KLIB_TRACE_SIZE - 1)];
+    }
 
-    // actual magic from Dr. Murray I guess
-    if(row == 0) { // top row
-        data = (*((unsigned int*)DATA_2_RO) & PMODB_TOP_MASK) >> 7; // mask off and shift to appropriate bit position
+    return n;
+#else
+    (void)out;
+    (void)max;
+
+    return 0;
+#endif
+}//end readMmioTrace()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        dumpMmioSummary();
+		
+        const char* path            File to write, NULL for stdout
+
+            Writes a table of every register the library touched since
+            resetMmioCounts(): reads, writes and redundant writes (same
+            value as the previous store), in total and per second, hottest
+            first. Redundant writes point at stores worth eliding.
+            Returns 0 on success, -1 without KLIB_IO_TRACE or if the file
+            could not be written.
         
-    } else { // bottom row
-        data = (*((unsigned int*)DATA_2_RO) & PMODB_BOTTOM_MASK) >> 11; // mask off and shift to appropriate bit position
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+#ifdef KLIB_IO_TRACE
+// Names for the summary, registers not listed show as their address only
+static const struct {
+    unsigned int addr;
+    const char* name;
+} klib_reg_names[] = {
+    {BUTTONS_ADDR, "BUTTONS_ADDR"}, {SWITCHES_ADDR, "SWITCHES_ADDR"}, {LED_ADDR, "LED_ADDR"},
+    {BUTTONS_ADDR + AXI_GPIO_GIER, "BUTTONS_GIER"}, {BUTTONS_ADDR + AXI_GPIO_IP_ISR, "BUTTONS_IP_ISR"},
+    {BUTTONS_ADDR + AXI_GPIO_IP_IER, "BUTTONS_IP_IER"}, {SWITCHES_ADDR + AXI_GPIO_GIER, "SWITCHES_GIER"},
+    {SWITCHES_ADDR + AXI_GPIO_IP_ISR, "SWITCHES_IP_ISR"}, {SWITCHES_ADDR + AXI_GPIO_IP_IER, "SWITCHES_IP_IER"},
+    {SEVSEG_CTRL_ADDR, "SEVSEG_CTRL_ADDR"}, {SEVSEG_DATA_ADDR, "SEVSEG_DATA_ADDR"},
+    {RGB_EN_1B_ADDR, "RGB_EN_1B_ADDR"}, {RGB_EN_1G_ADDR, "RGB_EN_1G_ADDR"}, {RGB_EN_1R_ADDR, "RGB_EN_1R_ADDR"},
+    {RGB_EN_2B_ADDR, "RGB_EN_2B_ADDR"}, {RGB_EN_2G_ADDR, "RGB_EN_2G_ADDR"}, {RGB_EN_2R_ADDR, "RGB_EN_2R_ADDR"},
+    {RGB_PERIOD_1B_ADDR, "RGB_PERIOD_1B_ADDR"}, {RGB_PERIOD_1G_ADDR, "RGB_PERIOD_1G_ADDR"}, {RGB_PERIOD_1R_ADDR, "RGB_PERIOD_1R_ADDR"},
+    {RGB_PERIOD_2B_ADDR, "RGB_PERIOD_2B_ADDR"}, {RGB_PERIOD_2G_ADDR, "RGB_PERIOD_2G_ADDR"}, {RGB_PERIOD_2R_ADDR, "RGB_PERIOD_2R_ADDR"},
+    {RGB_WIDTH_1B_ADDR, "RGB_WIDTH_1B_ADDR"}, {RGB_WIDTH_1G_ADDR, "RGB_WIDTH_1G_ADDR"}, {RGB_WIDTH_1R_ADDR, "RGB_WIDTH_1R_ADDR"},
+    {RGB_WIDTH_2B_ADDR, "RGB_WIDTH_2B_ADDR"}, {RGB_WIDTH_2G_ADDR, "RGB_WIDTH_2G_ADDR"}, {RGB_WIDTH_2R_ADDR, "RGB_WIDTH_2R_ADDR"},
+    {MASK_DATA_2_LSW, "MASK_DATA_2_LSW"}, {DATA_2, "DATA_2"}, {DATA_2_RO, "DATA_2_RO"}, {DIR_2, "DIR_2"}, {OE_2, "OE_2"}
+};
+#endif
+
+int dumpMmioSummary(const char* path) {
+
+#ifdef KLIB_IO_TRACE
+    const double seconds = (double)(getNanos() - klib_trace_start) / 1e9;
+    unsigned long reads, writes, redundant, total, best_total;
+    unsigned char done[KLIB_WINDOW_COUNT][KLIB_TRACE_REGS];
+    const char* name;
+    unsigned int addr;
+    int w, r, best_w, best_r;
+    unsigned int n;
+    FILE* f = (path == NULL) ? stdout : fopen(path, "w");
 
+    if(f == NULL) {
+        return -1;
     }
 
-    return data;
+    fprintf(f, "klib-io MMIO summary over %.3f s: %lu reads, %lu writes\n", seconds, klib_mmio_reads, klib_mmio_writes);
+    fprintf(f, "%-10s  %-20s %12s %12s %12s %12s %12s\n", "address", "register", "reads", "writes", "redundant", "writes/s", "redundant/s");
+
+    // hottest register first: a selection sort, the table is only ever a few dozen rows
+    memset(done, 0, sizeof(done));
+    for(;;) {
+        best_total = 0;
+        best_w = -1;
+        best_r = 0;
+        for(w = 0; w < KLIB_WINDOW_COUNT; w++) {
+            for(r = 0; r < KLIB_TRACE_REGS; r++) {
+                total = atomic_load_explicit(&klib_trace_reads[w][r], memory_order_relaxed) +
+                        atomic_load_explicit(&klib_trace_writes[w][r], memory_order_relaxed);
+                if(!done[w][r] && total > best_total) {
+                    best_total = total;
+                    best_w = w;
+                    best_r = r;
+                }
+            }
+        }
+        if(best_w < 0) {
+            break;
+        }
+        done[best_w][best_r] = 1;
+
+        addr = klib_window_addr[best_w] + best_r * 4;
+        reads = atomic_load_explicit(&klib_trace_reads[best_w][best_r], memory_order_relaxed);
+        writes = atomic_load_explicit(&klib_trace_writes[best_w][best_r], memory_order_relaxed);
+        redundant = atomic_load_explicit(&klib_trace_redundant[best_w][best_r], memory_order_relaxed);
+
+        name = "";
+        for(n = 0; n < sizeof(klib_reg_names) / sizeof(klib_reg_names[0]); n++) {
+            if(klib_reg_names[n].addr == addr) {
+                name = klib_reg_names[n].name;
+            }
+        }
+
+        fprintf(f, "0x%08X  %-20s %12lu %12lu %12lu %12.0f %12.0f\n", addr, name, reads, writes, redundant,
+                seconds > 0 ? writes / seconds : 0.0, seconds > 0 ? redundant / seconds : 0.0);
+    }
+
+    if(f != stdout) {
+        fclose(f);
+    }
+
+    return 0;
+#else
+    (void)path;
+
+    return -1;
+#endif
+}//end dumpMmioSummary()
+
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        Timing
+
+            getNanos() reads the ARM global timer where it is mapped and
+            clock_gettime() elsewhere. calibrateTiming() measures what
+            reading the clock, spinning and sleeping cost on the running
+            system, and delayNs()/waitUntilNs() correct for it.
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+#define GTIMER_NS_MULT ((1000000000ULL << 24) / KLIB_GTIMER_HZ) // ns per tick, 40.24 fixed point
+#define TIMING_SAMPLES 256
+
+// until calibrateTiming() runs, waits under 200 us spin
+static klibTiming klib_timing = {0, 0, 0, 0, 200000, false};
+
+// Spins until getNanos() reaches 'deadline', for waits too short to ever sleep
+static inline void spinUntilNs(unsigned long long deadline) {
+
+    while(getNanos() < deadline) {
+    }
+
+    return;
 }
 
 /* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-        pmodWrite();
+        getNanos();
+
+            Monotonic nanosecond clock. On the board (bare-metal and
+            /dev/mem backends) it reads the 64-bit ARM global timer, so it
+            is cycle-accurate and costs two loads. Elsewhere, or when
+            initKlibIo() finds the counter stopped, it falls back to
+            clock_gettime(CLOCK_MONOTONIC).
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+unsigned long long getNanos() {
+
+    unsigned int hi, lo;
+#ifdef __linux__
+    struct timespec ts;
+
+    if(klib_gtimer == NULL) {
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+    }
+#endif
+
+    // the halves are read separately, retry if the upper one ticked in between
+    do {
+        hi = klib_gtimer[1];
+        lo = klib_gtimer[0];
+    } while(klib_gtimer[1] != hi);
+
+    // whole 2^32-tick spans, then the rest, so a 32-bit CPU never needs a 64-bit divide
+    return (unsigned long long)hi * (GTIMER_NS_MULT << 8) + (((unsigned long long)lo * GTIMER_NS_MULT) >> 24);
+}//end getNanos()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        delayNs();
 		
-        bool row                top (0) or bottom (1) row
-        unsigned int data       data to be written to the selected PMOD B row       
+        unsigned long ns            Nanoseconds to wait
 
-            Writes a 4-bit value to the PMOD B row selected
+            Busy-waits for 'ns', corrected for the measured cost of reading
+            the clock. Accuracy is bounded by the spin jitter reported by
+            getTimingStats().
         
-        Written by Koby Miller
-        Originally written by Dr. Jacob Murray
-        Last modified: February 9th, 2024
+        Last modified: October 17th, 2026
 +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
-void pmodWrite(bool row, unsigned int data) {
+void delayNs(unsigned long ns) {
 
-    setupPmod(1, row); // ensure output mode
+    unsigned long long deadline;
 
-    // actual magic from Dr. Murray I guess
-    if(row == 0) { // top row
-        *((unsigned int*) DATA_2) = (*((unsigned int*)DATA_2) & ~PMODB_TOP_MASK) | ((data << 7) & PMODB_TOP_MASK);	
+    // reading the clock below already takes about clock_ns
+    if(ns <= klib_timing.clock_ns) {
+        return;
+    }
+    deadline = getNanos() + ns - klib_timing.clock_ns;
+
+    spinUntilNs(deadline);
+
+    return;
+}//end delayNs()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        waitUntilNs();
+		
+        unsigned long long deadline getNanos() time to wait for
+
+            Deadline wait for periodic work: waiting for absolute times
+            keeps a loop from drifting. Sleeps through the part of the wait
+            that is longer than the measured sleep jitter, then spins the
+            rest, so long waits free the CPU and short ones stay precise.
+        
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void waitUntilNs(unsigned long long deadline) {
 
-    } else { // bottom row
-        *((unsigned int*) DATA_2) = (*((unsigned int*)DATA_2) & ~PMODB_BOTTOM_MASK) | ((data << 11) & PMODB_BOTTOM_MASK);
+#ifdef __linux__
+    struct timespec ts;
+    unsigned long long now = getNanos();
+    unsigned long long sleep_ns;
 
+    if(deadline > now + klib_timing.spin_below_ns) {
+        sleep_ns = deadline - now - klib_timing.spin_below_ns;
+        ts.tv_sec = sleep_ns / 1000000000ULL;
+        ts.tv_nsec = sleep_ns % 1000000000ULL;
+        clock_nanosleep(CLOCK_MONOTONIC, 0, &ts, NULL);
     }
+#endif
+
+    spinUntilNs(deadline);
+
+    return;
+}//end waitUntilNs()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        calibrateTiming();
+
+            Measures the clock cost and resolution and the jitter of spinning
+            and sleeping, which delayNs() and waitUntilNs() then rely on.
+            initKlibIo() runs it; call it again after changing CPU frequency
+            or scheduling policy. Takes a few milliseconds.
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void calibrateTiming() {
+
+    unsigned long long t0, t1, prev, now, worst;
+    unsigned long long resolution = ~0ULL;
+    int c;
+#ifdef __linux__
+    struct timespec ts = {0, 50000};
+#endif
+
+#ifndef __linux__
+    klib_gtimer[2] |= 1; // bare-metal: make sure the global timer counts
+#endif
+    klib_timing.global_timer = (klib_gtimer != NULL);
+
+    // clock cost is the mean of back-to-back reads, resolution their smallest step
+    t0 = prev = getNanos();
+    for(c = 0; c < TIMING_SAMPLES; c++) {
+        now = getNanos();
+        if(now != prev && now - prev < resolution) {
+            resolution = now - prev;
+        }
+        prev = now;
+    }
+    klib_timing.clock_ns = (unsigned int)((prev - t0) / TIMING_SAMPLES);
+    klib_timing.resolution_ns = (resolution == ~0ULL) ? 0 : (unsigned int)resolution;
+
+    // spin jitter: worst overshoot of a 1 us delay
+    worst = 0;
+    for(c = 0; c < TIMING_SAMPLES / 4; c++) {
+        t0 = getNanos();
+        delayNs(1000);
+        t1 = getNanos();
+        if(t1 - t0 > 1000 + worst) {
+            worst = t1 - t0 - 1000;
+        }
+    }
+    klib_timing.spin_jitter_ns = (unsigned int)worst;
+
+#ifdef __linux__
+    // sleep jitter: worst overshoot of a 50 us sleep
+    worst = 0;
+    for(c = 0; c < 16; c++) {
+        t0 = getNanos();
+        clock_nanosleep(CLOCK_MONOTONIC, 0, &ts, NULL);
+        t1 = getNanos();
+        if(t1 - t0 > (unsigned long long)ts.tv_nsec + worst) {
+            worst = t1 - t0 - ts.tv_nsec;
+        }
+    }
+    klib_timing.sleep_jitter_ns = (unsigned int)worst;
+
+    // a sleep has to end at least one worst-case overshoot early, with the same again as margin
+    klib_timing.spin_below_ns = 2 * klib_timing.sleep_jitter_ns + klib_timing.spin_jitter_ns;
+#else
+    klib_timing.sleep_jitter_ns = 0;
+    klib_timing.spin_below_ns = ~0u; // nothing to sleep on, always spin
+#endif
+
+    return;
+}//end calibrateTiming()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        getTimingStats();
+		
+        klibTiming* t               Filled with the last calibration
+
+            Reports the measured jitter, to choose between sleeping and
+            spinning for a given interval
+        
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void getTimingStats(klibTiming* t) {
+
+    *t = klib_timing;
 
     return;
-}
\ No newline at end of file
+}//end getTimingStats()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        getButtonStates();
+            
+            Returns button states as a 4-bit binary number
+            
+            Each digit corresponds to 1 of 4 buttons
+            
+        Written by Koby Miller
+        Last modified: January 30th, 2024
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+unsigned int getButtonStates() {
+
+	unsigned int button_states = 0;
+
+    // read memory address of buttons
+	button_states = mmioRead(BUTTONS_ADDR);
+
+	// bitwise-and to check with 4 digits for 4 buttons
+    button_states &= 0b1111;
+
+	return button_states;
+}//end getButtonStates()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        getSwitchStates();
+            
+            Returns switch states as a 12-bit binary number
+            
+            Each digit corresponds to 1 of 12 buttons
+            
+        Written by Koby Miller
+        Last modified: January 30th, 2024
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+unsigned int getSwitchStates() {
+
+	unsigned int switch_states = 0;
+
+    // read memory address of switches
+	switch_states = mmioRead(SWITCHES_ADDR);
+
+	// bitwise-and to check with 12 digits for 12 buttons
+    switch_states &= 0b111111111111;
+
+	return switch_states;
+}//end getSwitchStates()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        Seven-segment glyph table
+
+            One entry per char, built at compile time from the SEVSEG_CHAR_*
+            macros. Entries are stored inverted (SEVSEG_GLYPH) so every char
+            left out of the initializer reads as 0 and decodes to a blank
+            digit with its decimal point off. Upper/lower case share a glyph
+            when only one of them is available, same as the old switch-case.
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+#define SEVSEG_GLYPH(ch) ((ch) ^ 0x7F) // inverted so that 0 means blank + decimal point off
+
+static const unsigned char sevseg_glyph[256] = {
+    ['A'] = SEVSEG_GLYPH(SEVSEG_CHAR_A), ['a'] = SEVSEG_GLYPH(SEVSEG_CHAR_A),
+    ['B'] = SEVSEG_GLYPH(SEVSEG_CHAR_B), ['b'] = SEVSEG_GLYPH(SEVSEG_CHAR_B),
+    ['C'] = SEVSEG_GLYPH(SEVSEG_CHAR_C), ['c'] = SEVSEG_GLYPH(SEVSEG_CHAR_c),
+    ['D'] = SEVSEG_GLYPH(SEVSEG_CHAR_D), ['d'] = SEVSEG_GLYPH(SEVSEG_CHAR_D),
+    ['E'] = SEVSEG_GLYPH(SEVSEG_CHAR_E), ['e'] = SEVSEG_GLYPH(SEVSEG_CHAR_E),
+    ['F'] = SEVSEG_GLYPH(SEVSEG_CHAR_F), ['f'] = SEVSEG_GLYPH(SEVSEG_CHAR_F),
+    ['G'] = SEVSEG_GLYPH(SEVSEG_CHAR_G), ['g'] = SEVSEG_GLYPH(SEVSEG_CHAR_g),
+    ['H'] = SEVSEG_GLYPH(SEVSEG_CHAR_H), ['h'] = SEVSEG_GLYPH(SEVSEG_CHAR_h),
+    ['I'] = SEVSEG_GLYPH(SEVSEG_CHAR_I), ['i'] = SEVSEG_GLYPH(SEVSEG_CHAR_i),
+    ['J'] = SEVSEG_GLYPH(SEVSEG_CHAR_J), ['j'] = SEVSEG_GLYPH(SEVSEG_CHAR_J),
+    ['L'] = SEVSEG_GLYPH(SEVSEG_CHAR_L), ['l'] = SEVSEG_GLYPH(SEVSEG_CHAR_l),
+    ['N'] = SEVSEG_GLYPH(SEVSEG_CHAR_N), ['n'] = SEVSEG_GLYPH(SEVSEG_CHAR_n),
+    ['O'] = SEVSEG_GLYPH(SEVSEG_CHAR_O), ['o'] = SEVSEG_GLYPH(SEVSEG_CHAR_o),
+    ['P'] = SEVSEG_GLYPH(SEVSEG_CHAR_P), ['p'] = SEVSEG_GLYPH(SEVSEG_CHAR_P),
+    ['Q'] = SEVSEG_GLYPH(SEVSEG_CHAR_Q), ['q'] = SEVSEG_GLYPH(SEVSEG_CHAR_Q),
+    ['R'] = SEVSEG_GLYPH(SEVSEG_CHAR_R), ['r'] = SEVSEG_GLYPH(SEVSEG_CHAR_R),
+    ['S'] = SEVSEG_GLYPH(SEVSEG_CHAR_S), ['s'] = SEVSEG_GLYPH(SEVSEG_CHAR_S),
+    ['T'] = SEVSEG_GLYPH(SEVSEG_CHAR_T), ['t'] = SEVSEG_GLYPH(SEVSEG_CHAR_T),
+    ['U'] = SEVSEG_GLYPH(SEVSEG_CHAR_U), ['u'] = SEVSEG_GLYPH(SEVSEG_CHAR_u),
+    ['Y'] = SEVSEG_GLYPH(SEVSEG_CHAR_Y), ['y'] = SEVSEG_GLYPH(SEVSEG_CHAR_Y),
+    ['0'] = SEVSEG_GLYPH(SEVSEG_CHAR_0), ['1'] = SEVSEG_GLYPH(SEVSEG_CHAR_1),
+    ['2'] = SEVSEG_GLYPH(SEVSEG_CHAR_2), ['3'] = SEVSEG_GLYPH(SEVSEG_CHAR_3),
+    ['4'] = SEVSEG_GLYPH(SEVSEG_CHAR_4), ['5'] = SEVSEG_GLYPH(SEVSEG_CHAR_5),
+    ['6'] = SEVSEG_GLYPH(SEVSEG_CHAR_6), ['7'] = SEVSEG_GLYPH(SEVSEG_CHAR_7),
+    ['8'] = SEVSEG_GLYPH(SEVSEG_CHAR_8), ['9'] = SEVSEG_GLYPH(SEVSEG_CHAR_9),
+    ['-'] = SEVSEG_GLYPH(SEVSEG_CHAR_DASH),
+    ['='] = SEVSEG_GLYPH(SEVSEG_CHAR_EQUAL),
+    ['_'] = SEVSEG_GLYPH(SEVSEG_CHAR_UNDERSCORE)
+};
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        Decimal digits
+
+            Splits 0-9999 into four BCD digits, one per byte, ones digit in the
+            least significant byte (the layout default mode expects).
+
+            x / 10 == (x * 0xCCCD) >> 19 for every x below 81920, so the
+            digits come out of multiplies and shifts instead of the four
+            '%' and '/' pairs, which are library calls on cores without a
+            hardware divider.
+
+            Building with KLIB_SEVSEG_DEC_TABLE trades 40KB of read-only
+            data for a table of all 10000 finished frames, built at compile
+            time.
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+static inline unsigned int decimalDigits(unsigned int val) {
+
+    unsigned int disp = 0;
+    unsigned int q;
+    int c;
+
+    for(c = 0; c < 4; c++) {
+        q = (val * 0xCCCD) >> 19;           // val / 10
+        disp |= (val - q * 10) << (c * 8);  // val % 10
+        val = q;
+    }
+
+    return disp;
+}
+
+#ifdef KLIB_SEVSEG_DEC_TABLE
+// Every finished frame, spelled out by the preprocessor so the table is const data shared by all threads
+#define SEVSEG_DEC_ONES(x)      (x), (x) | 1, (x) | 2, (x) | 3, (x) | 4, (x) | 5, (x) | 6, (x) | 7, (x) | 8, (x) | 9
+#define SEVSEG_DEC_TENS(x)      SEVSEG_DEC_ONES((x) | 0x000), SEVSEG_DEC_ONES((x) | 0x100), SEVSEG_DEC_ONES((x) | 0x200), \
+                                SEVSEG_DEC_ONES((x) | 0x300), SEVSEG_DEC_ONES((x) | 0x400), SEVSEG_DEC_ONES((x) | 0x500), \
+                                SEVSEG_DEC_ONES((x) | 0x600), SEVSEG_DEC_ONES((x) | 0x700), SEVSEG_DEC_ONES((x) | 0x800), \
+                                SEVSEG_DEC_ONES((x) | 0x900)
+#define SEVSEG_DEC_HUNDREDS(x)  SEVSEG_DEC_TENS((x) | 0x00000), SEVSEG_DEC_TENS((x) | 0x10000), SEVSEG_DEC_TENS((x) | 0x20000), \
+                                SEVSEG_DEC_TENS((x) | 0x30000), SEVSEG_DEC_TENS((x) | 0x40000), SEVSEG_DEC_TENS((x) | 0x50000), \
+                                SEVSEG_DEC_TENS((x) | 0x60000), SEVSEG_DEC_TENS((x) | 0x70000), SEVSEG_DEC_TENS((x) | 0x80000), \
+                                SEVSEG_DEC_TENS((x) | 0x90000)
+
+static const unsigned int sevseg_dec_table[10000] = {
+    SEVSEG_DEC_HUNDREDS(0x80808080u), SEVSEG_DEC_HUNDREDS(0x81808080u), SEVSEG_DEC_HUNDREDS(0x82808080u),
+    SEVSEG_DEC_HUNDREDS(0x83808080u), SEVSEG_DEC_HUNDREDS(0x84808080u), SEVSEG_DEC_HUNDREDS(0x85808080u),
+    SEVSEG_DEC_HUNDREDS(0x86808080u), SEVSEG_DEC_HUNDREDS(0x87808080u), SEVSEG_DEC_HUNDREDS(0x88808080u),
+    SEVSEG_DEC_HUNDREDS(0x89808080u)
+};
+
+static inline unsigned int decimalFrame(unsigned int val) {
+    return sevseg_dec_table[val];
+}
+#else
+static inline unsigned int decimalFrame(unsigned int val) {
+    return decimalDigits(val) | 0x80808080;
+}
+#endif
+
+// Custom-mode frame for decimal values default mode cannot show:
+// -999 to -1 get a leading dash, anything else out of range shows "----"
+static unsigned int decimalFrameSigned(int val) {
+
+    char chars[4] = {'-', '-', '-', '-'};
+    unsigned int digits;
+
+    if(val < 0 && val >= -999) {
+        digits = decimalDigits((unsigned int)-val);
+        chars[1] = '0' + ((digits >> 16) & 0xF);
+        chars[2] = '0' + ((digits >> 8) & 0xF);
+        chars[3] = '0' + (digits & 0xF);
+    }
+
+    return encodeSevSegChars(chars);
+}
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        enableSevSeg();
+		
+        unsigned int mode       Determines whether the display operates in 'custom' or 'default' mode
+            
+            Used to enable the seven-segment display
+            in either custom or default mode
+
+            0 for default, 1 for custom
+            
+        Written by Koby Miller
+        Last modified: February 9th, 2024
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void enableSevSeg(unsigned int mode) {
+    
+    periphLock(KLIB_PERIPH_SEVSEG);
+
+    // if mode is set to 1, enable custom mode, else, leave it off
+    // 1st bit enables, 2nd bit determines mode
+    if(mode == 1) {
+        shadowWrite(SEVSEG_CTRL_ADDR, 0b11);
+    } else {
+        shadowWrite(SEVSEG_CTRL_ADDR, 0b01);
+    }
+
+    periphUnlock(KLIB_PERIPH_SEVSEG);
+
+    return;
+}//end enableSevSeg()
+
+// SEVSEG_DATA word outputToSevSeg() shows for 'val', '*ctrl' gets the SEVSEG_CTRL value it needs
+static unsigned int sevSegValueFrame(int val, byte mode, unsigned int* ctrl) {
+
+    unsigned int disp = 0;
+    byte c;
+
+    *ctrl = 0b01; // number mode
+
+    switch(mode) {
+        default:
+        case 0: //hexadecimal
+            
+            for(c = 0; c < 4; c++)
+            {
+                disp |= (val & 0xF) << (c * 8); // Shift over bits based on digit of display
+                val >>= 4; // Shift out least significant digit (divide by 2^4)
+            }
+            
+            break;
+        
+        case 1: //decimal
+
+            // negative and 5+ digit values need the dash, so custom mode
+            if(val < 0 || val > 9999) {
+                *ctrl = 0b11;
+                return decimalFrameSigned(val);
+            }
+
+            return decimalFrame((unsigned int)val);
+        case 2: //binary
+            
+            for(c = 0; c < 4; c++)
+            {
+                disp |= (val & 1) << (c * 8); // Shift over bits based on digit of display
+                val >>= 1; // Shift out least significant digit (divide by 2^4)
+            }
+            
+            break;
+    }
+    
+    // Turn of decimal points
+    disp |= 0x80808080;
+
+    return disp;
+}
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        outputToSevSeg();
+		
+        int val                 Value to push to the seven-segment display
+        byte mode               Display mode. 0-hexadecimal, 1-decimal, 2-binary
+            
+            Used to display data on the seven-segment display
+
+            In decimal mode, -999 to -1 are shown with a leading dash and
+            values outside -999 to 9999 show "----"
+            
+        Written by Koby Miller
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void outputToSevSeg(int val, byte mode) {
+
+    unsigned int ctrl;
+    const unsigned int disp = sevSegValueFrame(val, mode, &ctrl);
+
+    periphLock(KLIB_PERIPH_SEVSEG);
+
+    // ensure sev-seg is in the mode the frame was built for
+    shadowWrite(SEVSEG_CTRL_ADDR, ctrl);
+
+    // Write data to display data memory address
+    shadowWrite(SEVSEG_DATA_ADDR, disp);
+            
+    periphUnlock(KLIB_PERIPH_SEVSEG);
+
+    return;
+}//end outputToSevSeg()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        encodeSevSegChars();
+		
+        const char* chars       Exactly 4 characters, NUL is not treated specially
+
+            Returns the 32-bit SEVSEG_DATA word (custom mode) for the four
+            characters, leftmost character in the most significant byte.
+            Four table loads and no branches.
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+unsigned int encodeSevSegChars(const char* chars) {
+
+    const unsigned char* u = (const unsigned char*)chars;
+
+    // table entries are inverted, flip all four back at once
+    return ~(((unsigned int)sevseg_glyph[u[0]] << 24) |
+             ((unsigned int)sevseg_glyph[u[1]] << 16) |
+             ((unsigned int)sevseg_glyph[u[2]] << 8) |
+              (unsigned int)sevseg_glyph[u[3]]);
+}//end encodeSevSegChars()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        encodeSevSeg();
+		
+        const char* str         Input string, only first 4 characters are used
+
+            Returns the 32-bit SEVSEG_DATA word (custom mode) for a string.
+            Strings shorter than 4 characters are padded with blanks.
+            Encode once and pass the result to outputToSevSegFrame() to show
+            the same text repeatedly without re-encoding it.
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+unsigned int encodeSevSeg(const char* str) {
+
+    char chars[4] = {0, 0, 0, 0}; // NUL has no glyph, so padding is blank
+    int c;
+
+    for(c = 0; c < 4 && str[c] != '\0'; c++) {
+        chars[c] = str[c];
+    }
+
+    return encodeSevSegChars(chars);
+}//end encodeSevSeg()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        Batch encoders
+
+            encodeSevSegValues() works on 16-bit lanes: decimal values are
+            saturated to int16 (everything outside -999 to 9999 stays
+            outside), split into digits with x / 10 == (x * 0xCCCD) >> 19
+            through a 16-bit high multiply, and the four digit indices of
+            each value are zipped into one 32-bit lane. Hex and binary only
+            need their nibbles/bits spread to one per byte. One shuffle
+            through a 16-entry table (sevSegDigitTable()) then turns every
+            byte into its glyph.
+
+            encodeSevSegStrings() uses the 256-entry sevseg_glyph table
+            directly: only 0x20-0x7F have glyphs, so SSSE3/AVX2 pick one of
+            six 16-byte rows by the high nibble, and NEON does three 32-byte
+            VTBL/VTBX lookups. Bytes are then reversed within each word
+            (first character in the most significant byte) and inverted.
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+static const char sevseg_hex_chars[16] = {'0', '1', '2', '3', '4', '5', '6', '7',
+                                          '8', '9', 'A', 'b', 'C', 'd', 'E', 'F'};
+
+// Glyph of every digit 0-F, index 10 becomes the dash for decimal (digit indices never exceed 9 there)
+static void sevSegDigitTable(unsigned char* lut, byte mode) {
+
+    int d;
+
+    for(d = 0; d < 16; d++) {
+        lut[d] = (unsigned char)~sevseg_glyph[(unsigned char)sevseg_hex_chars[d]];
+    }
+    if(mode == 1) {
+        lut[10] = (unsigned char)~sevseg_glyph['-'];
+    }
+}
+
+#if defined(__AVX2__)
+static size_t encodeDecimalSimd(const int* vals, unsigned int* frames, size_t n, const unsigned char* lut) {
+
+    const __m256i table = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)lut));
+    const __m256i magic = _mm256_set1_epi16((short)0xCCCD);
+    const __m256i ten = _mm256_set1_epi16(10);
+    __m256i v, a, q, d0, d1, d2, d3, neg, oor, lo, hi;
+    size_t i;
+
+    for(i = 0; i + 16 <= n; i += 16) {
+        // packs works per 128-bit lane, so the unpacks below restore the order
+        v = _mm256_packs_epi32(_mm256_loadu_si256((const __m256i*)(vals + i)),
+                               _mm256_loadu_si256((const __m256i*)(vals + i + 8)));
+        neg = _mm256_cmpgt_epi16(_mm256_setzero_si256(), v);
+        oor = _mm256_or_si256(_mm256_cmpgt_epi16(v, _mm256_set1_epi16(9999)),
+                              _mm256_cmpgt_epi16(_mm256_set1_epi16(-999), v));
+        a = _mm256_abs_epi16(v);
+
+        q = _mm256_srli_epi16(_mm256_mulhi_epu16(a, magic), 3);
+        d0 = _mm256_sub_epi16(a, _mm256_mullo_epi16(q, ten));
+        a = q;
+        q = _mm256_srli_epi16(_mm256_mulhi_epu16(a, magic), 3);
+        d1 = _mm256_sub_epi16(a, _mm256_mullo_epi16(q, ten));
+        a = q;
+        q = _mm256_srli_epi16(_mm256_mulhi_epu16(a, magic), 3);
+        d2 = _mm256_sub_epi16(a, _mm256_mullo_epi16(q, ten));
+        d3 = _mm256_blendv_epi8(q, ten, neg); // thousands digit is 0 for -999 to -1, show the dash there
+
+        d0 = _mm256_blendv_epi8(d0, ten, oor);
+        d1 = _mm256_blendv_epi8(d1, ten, oor);
+        d2 = _mm256_blendv_epi8(d2, ten, oor);
+        d3 = _mm256_blendv_epi8(d3, ten, oor);
+
+        lo = _mm256_or_si256(d0, _mm256_slli_epi16(d1, 8));
+        hi = _mm256_or_si256(d2, _mm256_slli_epi16(d3, 8));
+        _mm256_storeu_si256((__m256i*)(frames + i), _mm256_shuffle_epi8(table, _mm256_unpacklo_epi16(lo, hi)));
+        _mm256_storeu_si256((__m256i*)(frames + i + 8), _mm256_shuffle_epi8(table, _mm256_unpackhi_epi16(lo, hi)));
+    }
+
+    return i;
+}
+
+static size_t encodeNibblesSimd(const int* vals, unsigned int* frames, size_t n, const unsigned char* lut, byte mode) {
+
+    const __m256i table = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)lut));
+    __m256i t;
+    size_t i;
+
+    for(i = 0; i + 8 <= n; i += 8) {
+        t = _mm256_loadu_si256((const __m256i*)(vals + i));
+        if(mode == 2) {
+            t = _mm256_and_si256(t, _mm256_set1_epi32(0xF));
+            t = _mm256_or_si256(_mm256_or_si256(t, _mm256_slli_epi32(t, 7)),
+                                _mm256_or_si256(_mm256_slli_epi32(t, 14), _mm256_slli_epi32(t, 21)));
+            t = _mm256_and_si256(t, _mm256_set1_epi32(0x01010101));
+        } else {
+            t = _mm256_and_si256(t, _mm256_set1_epi32(0xFFFF));
+            t = _mm256_and_si256(_mm256_or_si256(t, _mm256_slli_epi32(t, 8)), _mm256_set1_epi32(0x00FF00FF));
+            t = _mm256_and_si256(_mm256_or_si256(t, _mm256_slli_epi32(t, 4)), _mm256_set1_epi32(0x0F0F0F0F));
+        }
+        _mm256_storeu_si256((__m256i*)(frames + i), _mm256_shuffle_epi8(table, t));
+    }
+
+    return i;
+}
+
+static size_t encodeStringsSimd(const char* text, unsigned int* frames, size_t n) {
+
+    const __m256i reverse = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                             3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    const __m256i low = _mm256_set1_epi8(0x0F);
+    __m256i rows[6];
+    __m256i ch, hi, lo, g;
+    size_t i;
+    int r;
+
+    for(r = 0; r < 6; r++) {
+        rows[r] = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)(sevseg_glyph + 0x20 + r * 16)));
+    }
+
+    for(i = 0; i + 8 <= n; i += 8) {
+        ch = _mm256_loadu_si256((const __m256i*)(text + i * 4));
+        hi = _mm256_and_si256(_mm256_srli_epi16(ch, 4), low);
+        lo = _mm256_and_si256(ch, low);
+        g = _mm256_setzero_si256();
+        for(r = 0; r < 6; r++) {
+            g = _mm256_or_si256(g, _mm256_and_si256(_mm256_cmpeq_epi8(hi, _mm256_set1_epi8((char)(r + 2))),
+                                                    _mm256_shuffle_epi8(rows[r], lo)));
+        }
+        g = _mm256_shuffle_epi8(g, reverse);
+        _mm256_storeu_si256((__m256i*)(frames + i), _mm256_xor_si256(g, _mm256_set1_epi8(-1)));
+    }
+
+    return i;
+}
+#elif defined(__SSSE3__)
+static size_t encodeDecimalSimd(const int* vals, unsigned int* frames, size_t n, const unsigned char* lut) {
+
+    const __m128i table = _mm_loadu_si128((const __m128i*)lut);
+    const __m128i magic = _mm_set1_epi16((short)0xCCCD);
+    const __m128i ten = _mm_set1_epi16(10);
+    __m128i v, a, q, d0, d1, d2, d3, neg, oor, lo, hi;
+    size_t i;
+
+    for(i = 0; i + 8 <= n; i += 8) {
+        v = _mm_packs_epi32(_mm_loadu_si128((const __m128i*)(vals + i)),
+                            _mm_loadu_si128((const __m128i*)(vals + i + 4)));
+        neg = _mm_cmplt_epi16(v, _mm_setzero_si128());
+        oor = _mm_or_si128(_mm_cmpgt_epi16(v, _mm_set1_epi16(9999)), _mm_cmplt_epi16(v, _mm_set1_epi16(-999)));
+        a = _mm_abs_epi16(v);
+
+        q = _mm_srli_epi16(_mm_mulhi_epu16(a, magic), 3);
+        d0 = _mm_sub_epi16(a, _mm_mullo_epi16(q, ten));
+        a = q;
+        q = _mm_srli_epi16(_mm_mulhi_epu16(a, magic), 3);
+        d1 = _mm_sub_epi16(a, _mm_mullo_epi16(q, ten));
+        a = q;
+        q = _mm_srli_epi16(_mm_mulhi_epu16(a, magic), 3);
+        d2 = _mm_sub_epi16(a, _mm_mullo_epi16(q, ten));
+        d3 = _mm_or_si128(_mm_and_si128(neg, ten), _mm_andnot_si128(neg, q)); // dash in front of -999 to -1
+
+        d0 = _mm_or_si128(_mm_and_si128(oor, ten), _mm_andnot_si128(oor, d0));
+        d1 = _mm_or_si128(_mm_and_si128(oor, ten), _mm_andnot_si128(oor, d1));
+        d2 = _mm_or_si128(_mm_and_si128(oor, ten), _mm_andnot_si128(oor, d2));
+        d3 = _mm_or_si128(_mm_and_si128(oor, ten), _mm_andnot_si128(oor, d3));
+
+        lo = _mm_or_si128(d0, _mm_slli_epi16(d1, 8));
+        hi = _mm_or_si128(d2, _mm_slli_epi16(d3, 8));
+        _mm_storeu_si128((__m128i*)(frames + i), _mm_shuffle_epi8(table, _mm_unpacklo_epi16(lo, hi)));
+        _mm_storeu_si128((__m128i*)(frames + i + 4), _mm_shuffle_epi8(table, _mm_unpackhi_epi16(lo, hi)));
+    }
+
+    return i;
+}
+
+static size_t encodeNibblesSimd(const int* vals, unsigned int* frames, size_t n, const unsigned char* lut, byte mode) {
+
+    const __m128i table = _mm_loadu_si128((const __m128i*)lut);
+    __m128i t;
+    size_t i;
+
+    for(i = 0; i + 4 <= n; i += 4) {
+        t = _mm_loadu_si128((const __m128i*)(vals + i));
+        if(mode == 2) {
+            t = _mm_and_si128(t, _mm_set1_epi32(0xF));
+            t = _mm_or_si128(_mm_or_si128(t, _mm_slli_epi32(t, 7)), _mm_or_si128(_mm_slli_epi32(t, 14), _mm_slli_epi32(t, 21)));
+            t = _mm_and_si128(t, _mm_set1_epi32(0x01010101));
+        } else {
+            t = _mm_and_si128(t, _mm_set1_epi32(0xFFFF));
+            t = _mm_and_si128(_mm_or_si128(t, _mm_slli_epi32(t, 8)), _mm_set1_epi32(0x00FF00FF));
+            t = _mm_and_si128(_mm_or_si128(t, _mm_slli_epi32(t, 4)), _mm_set1_epi32(0x0F0F0F0F));
+        }
+        _mm_storeu_si128((__m128i*)(frames + i), _mm_shuffle_epi8(table, t));
+    }
+
+    return i;
+}
+
+static size_t encodeStringsSimd(const char* text, unsigned int* frames, size_t n) {
+
+    const __m128i reverse = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    const __m128i low = _mm_set1_epi8(0x0F);
+    __m128i rows[6];
+    __m128i ch, hi, lo, g;
+    size_t i;
+    int r;
+
+    for(r = 0; r < 6; r++) {
+        rows[r] = _mm_loadu_si128((const __m128i*)(sevseg_glyph + 0x20 + r * 16));
+    }
+
+    for(i = 0; i + 4 <= n; i += 4) {
+        ch = _mm_loadu_si128((const __m128i*)(text + i * 4));
+        hi = _mm_and_si128(_mm_srli_epi16(ch, 4), low);
+        lo = _mm_and_si128(ch, low);
+        g = _mm_setzero_si128();
+        for(r = 0; r < 6; r++) {
+            g = _mm_or_si128(g, _mm_and_si128(_mm_cmpeq_epi8(hi, _mm_set1_epi8((char)(r + 2))),
+                                              _mm_shuffle_epi8(rows[r], lo)));
+        }
+        g = _mm_shuffle_epi8(g, reverse);
+        _mm_storeu_si128((__m128i*)(frames + i), _mm_xor_si128(g, _mm_set1_epi8(-1)));
+    }
+
+    return i;
+}
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+// x / 10 on 16-bit lanes, exact below 81920
+static inline uint16x8_t div10Neon(uint16x8_t x) {
+
+    const uint16x4_t magic = vdup_n_u16(0xCCCD);
+
+    return vshrq_n_u16(vcombine_u16(vshrn_n_u32(vmull_u16(vget_low_u16(x), magic), 16),
+                                    vshrn_n_u32(vmull_u16(vget_high_u16(x), magic), 16)), 3);
+}
+
+// Looks up all 16 bytes of 'idx' (values 0-15) in the 16-entry table and stores 4 frames
+static inline void storeGlyphsNeon(unsigned int* frames, uint8x8x2_t table, uint8x16_t idx) {
+
+    vst1q_u8((uint8_t*)frames, vcombine_u8(vtbl2_u8(table, vget_low_u8(idx)), vtbl2_u8(table, vget_high_u8(idx))));
+}
+
+static size_t encodeDecimalSimd(const int* vals, unsigned int* frames, size_t n, const unsigned char* lut) {
+
+    const uint8x8x2_t table = {{vld1_u8(lut), vld1_u8(lut + 8)}};
+    const uint16x8_t ten = vdupq_n_u16(10);
+    int16x8_t v;
+    uint16x8_t a, q, d0, d1, d2, d3, neg, oor, lo, hi;
+    uint16x8x2_t words;
+    size_t i;
+
+    for(i = 0; i + 8 <= n; i += 8) {
+        v = vcombine_s16(vqmovn_s32(vld1q_s32((const int32_t*)(vals + i))), vqmovn_s32(vld1q_s32((const int32_t*)(vals + i + 4))));
+        neg = vcltq_s16(v, vdupq_n_s16(0));
+        oor = vorrq_u16(vcgtq_s16(v, vdupq_n_s16(9999)), vcltq_s16(v, vdupq_n_s16(-999)));
+        a = vreinterpretq_u16_s16(vabsq_s16(v));
+
+        q = div10Neon(a);
+        d0 = vmlsq_u16(a, q, ten);
+        a = q;
+        q = div10Neon(a);
+        d1 = vmlsq_u16(a, q, ten);
+        a = q;
+        q = div10Neon(a);
+        d2 = vmlsq_u16(a, q, ten);
+        d3 = vbslq_u16(neg, ten, q); // dash in front of -999 to -1
+
+        d0 = vbslq_u16(oor, ten, d0);
+        d1 = vbslq_u16(oor, ten, d1);
+        d2 = vbslq_u16(oor, ten, d2);
+        d3 = vbslq_u16(oor, ten, d3);
+
+        lo = vorrq_u16(d0, vshlq_n_u16(d1, 8));
+        hi = vorrq_u16(d2, vshlq_n_u16(d3, 8));
+        words = vzipq_u16(lo, hi);
+        storeGlyphsNeon(frames + i, table, vreinterpretq_u8_u16(words.val[0]));
+        storeGlyphsNeon(frames + i + 4, table, vreinterpretq_u8_u16(words.val[1]));
+    }
+
+    return i;
+}
+
+static size_t encodeNibblesSimd(const int* vals, unsigned int* frames, size_t n, const unsigned char* lut, byte mode) {
+
+    const uint8x8x2_t table = {{vld1_u8(lut), vld1_u8(lut + 8)}};
+    uint32x4_t t;
+    size_t i;
+
+    for(i = 0; i + 4 <= n; i += 4) {
+        t = vreinterpretq_u32_s32(vld1q_s32((const int32_t*)(vals + i)));
+        if(mode == 2) {
+            t = vandq_u32(t, vdupq_n_u32(0xF));
+            t = vorrq_u32(vorrq_u32(t, vshlq_n_u32(t, 7)), vorrq_u32(vshlq_n_u32(t, 14), vshlq_n_u32(t, 21)));
+            t = vandq_u32(t, vdupq_n_u32(0x01010101));
+        } else {
+            t = vandq_u32(t, vdupq_n_u32(0xFFFF));
+            t = vandq_u32(vorrq_u32(t, vshlq_n_u32(t, 8)), vdupq_n_u32(0x00FF00FF));
+            t = vandq_u32(vorrq_u32(t, vshlq_n_u32(t, 4)), vdupq_n_u32(0x0F0F0F0F));
+        }
+        storeGlyphsNeon(frames + i, table, vreinterpretq_u8_u32(t));
+    }
+
+    return i;
+}
+
+static size_t encodeStringsSimd(const char* text, unsigned int* frames, size_t n) {
+
+    const uint8_t* g = sevseg_glyph;
+    const uint8x8x4_t t0 = {{vld1_u8(g + 0x20), vld1_u8(g + 0x28), vld1_u8(g + 0x30), vld1_u8(g + 0x38)}};
+    const uint8x8x4_t t1 = {{vld1_u8(g + 0x40), vld1_u8(g + 0x48), vld1_u8(g + 0x50), vld1_u8(g + 0x58)}};
+    const uint8x8x4_t t2 = {{vld1_u8(g + 0x60), vld1_u8(g + 0x68), vld1_u8(g + 0x70), vld1_u8(g + 0x78)}};
+    uint8x8_t idx, r;
+    size_t i;
+
+    for(i = 0; i + 2 <= n; i += 2) {
+        // out-of-range indices give 0 (VTBL) or keep the byte (VTBX), which is the blank glyph
+        idx = vsub_u8(vld1_u8((const uint8_t*)text + i * 4), vdup_n_u8(0x20));
+        r = vtbl4_u8(t0, idx);
+        r = vtbx4_u8(r, t1, vsub_u8(idx, vdup_n_u8(32)));
+        r = vtbx4_u8(r, t2, vsub_u8(idx, vdup_n_u8(64)));
+        vst1_u8((uint8_t*)(frames + i), vmvn_u8(vrev32_u8(r)));
+    }
+
+    return i;
+}
+#else
+    #define encodeDecimalSimd(vals, frames, n, lut) ((size_t)0)
+    #define encodeNibblesSimd(vals, frames, n, lut, mode) ((size_t)0)
+    #define encodeStringsSimd(text, frames, n) ((size_t)0)
+#endif
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        encodeSevSegValue();
+		
+        int val                 Value to encode
+        byte mode               0-hexadecimal, 1-decimal, 2-binary, as for outputToSevSeg()
+
+            Returns the custom-mode SEVSEG_DATA word showing what
+            outputToSevSeg() would show for 'val' (leading zeros, leading
+            dash, "----" out of range), for outputToSevSegFrame().
+            The scalar reference encodeSevSegValues() is checked against.
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+unsigned int encodeSevSegValue(int val, byte mode) {
+
+    unsigned int digits = 0;
+    char chars[4];
+    int c;
+
+    switch(mode) {
+        default:
+        case 0: //hexadecimal
+            for(c = 0; c < 4; c++) {
+                digits |= ((val >> (c * 4)) & 0xF) << (c * 8);
+            }
+            break;
+
+        case 1: //decimal
+            if(val < 0 || val > 9999) {
+                return decimalFrameSigned(val);
+            }
+            digits = decimalDigits((unsigned int)val);
+            break;
+
+        case 2: //binary
+            for(c = 0; c < 4; c++) {
+                digits |= ((val >> c) & 1) << (c * 8);
+            }
+            break;
+    }
+
+    for(c = 0; c < 4; c++) {
+        chars[3 - c] = sevseg_hex_chars[(digits >> (c * 8)) & 0xF];
+    }
+
+    return encodeSevSegChars(chars);
+}//end encodeSevSegValue()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        encodeSevSegValues();
+		
+        const int* vals         Values to encode
+        unsigned int* frames    Receives one frame per value
+        size_t n                Number of values
+        byte mode               0-hexadecimal, 1-decimal, 2-binary
+
+            Batch version of encodeSevSegValue() for precomputing replays
+            and animations. Uses AVX2 (16 values a step), SSSE3 (8) or NEON
+            (8) when the compiler targets them (-mavx2, -mssse3 or
+            -march=native on hosts, -mfpu=neon on the Zynq), and a scalar
+            loop otherwise; getSevSegBatchPath() tells which one was built.
+            Decimal digits come from a multiply by 0xCCCD on 16-bit lanes
+            and a shuffle through a 16-entry glyph table, no division.
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void encodeSevSegValues(const int* vals, unsigned int* frames, size_t n, byte mode) {
+
+    unsigned char lut[16];
+    size_t i;
+
+    sevSegDigitTable(lut, mode);
+
+    i = (mode == 1) ? encodeDecimalSimd(vals, frames, n, lut) : encodeNibblesSimd(vals, frames, n, lut, mode);
+
+    // whatever didn't fill a whole vector
+    for(; i < n; i++) {
+        frames[i] = encodeSevSegValue(vals[i], mode);
+    }
+
+    return;
+}//end encodeSevSegValues()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        encodeSevSegStrings();
+		
+        const char* text        n records of exactly 4 characters, no separators
+        unsigned int* frames    Receives one frame per record
+        size_t n                Number of records
+
+            Batch version of encodeSevSegChars(), same result for every
+            record. The SIMD paths look up 16 (SSSE3), 32 (AVX2) or
+            8 (NEON) characters at a time in the glyph table.
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void encodeSevSegStrings(const char* text, unsigned int* frames, size_t n) {
+
+    size_t i = encodeStringsSimd(text, frames, n);
+
+    for(; i < n; i++) {
+        frames[i] = encodeSevSegChars(text + i * 4);
+    }
+
+    return;
+}//end encodeSevSegStrings()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        getSevSegBatchPath();
+
+            Returns the instruction set the batch encoders were built for:
+            "avx2", "ssse3", "neon" or "scalar"
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+const char* getSevSegBatchPath() {
+
+#if defined(__AVX2__)
+    return "avx2";
+#elif defined(__SSSE3__)
+    return "ssse3";
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}//end getSevSegBatchPath()
+
+// Powers of ten up to the width of the display
+static const unsigned int sevseg_pow10[5] = {1, 10, 100, 1000, 10000};
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        encodeSevSegFixed();
+		
+        int val                 Fixed-point value, e.g. 1234 for 12.34
+        unsigned int decimals   Digits of 'val' after the decimal point
+
+            Returns the custom-mode frame showing 'val' right-aligned with
+            its decimal point lit: 1234, 2 shows "12.34"; 5, 1 shows "0.5";
+            -35, 1 shows "-3.5". Negative values get SEVSEG_CHAR_DASH right
+            in front of the first digit. Fraction digits that don't fit are
+            rounded away (123456, 3 shows "123.5"), and values whose
+            integer part doesn't fit show "----".
+            Integer-only: multiplies and shifts, no division, no printf.
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+unsigned int encodeSevSegFixed(int val, unsigned int decimals) {
+
+    const bool neg = val < 0;
+    const unsigned int width = neg ? 3 : 4; // the dash takes a digit
+    unsigned int mag = neg ? 0u - (unsigned int)val : (unsigned int)val;
+    unsigned int digits, shown, frame;
+    unsigned int q, k;
+
+    // round fraction digits away until the rest fits, keeping one digit in front of the point
+    while(decimals > 0 && (mag >= sevseg_pow10[width] || decimals >= width)) {
+        q = (unsigned int)(((unsigned long long)mag * 0xCCCCCCCDULL) >> 35); // mag / 10, exact for 32 bits
+        mag = q + (mag - q * 10 >= 5);                                          // round half up
+        decimals--;
+    }
+    if(mag >= sevseg_pow10[width]) {
+        return encodeSevSegChars("----");
+    }
+
+    digits = decimalDigits(mag);
+    shown = (mag >= 1000) ? 4 : (mag >= 100) ? 3 : (mag >= 10) ? 2 : 1;
+    if(shown < decimals + 1) {
+        shown = decimals + 1; // leading zeros up to the point, "0.05"
+    }
+
+    // blanks everywhere, then the digits from the right
+    frame = 0xFFFFFFFF;
+    for(k = 0; k < shown; k++) {
+        frame ^= (unsigned int)(unsigned char)sevseg_glyph['0' + ((digits >> (k * 8)) & 0xF)] << (k * 8);
+    }
+    if(neg && mag != 0) {
+        frame ^= (unsigned int)(unsigned char)sevseg_glyph['-'] << (shown * 8);
+    }
+    if(decimals > 0) {
+        frame &= ~(0x80u << (decimals * 8)); // decimal point is active low
+    }
+
+    return frame;
+}//end encodeSevSegFixed()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        encodeSevSegFloat();
+		
+        float val               Value to show
+
+            Returns the custom-mode frame for 'val' with as many decimals
+            as fit: 3.14159 shows "3.142", -3.5 shows "-3.50", 1234.5 shows
+            "1235". NaN and values too large to fit show "----".
+            One scale and round to fixed point, then encodeSevSegFixed().
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+unsigned int encodeSevSegFloat(float val) {
+
+    const bool neg = val < 0.0f;
+    const unsigned int width = neg ? 3 : 4;
+    const float a = fabsf(val);
+    unsigned int decimals = width - 1;
+    float scaled;
+
+    if(val != val) {
+        return encodeSevSegChars("----"); // NaN
+    }
+
+    // most decimals whose rounded value still fits
+    scaled = a * (float)sevseg_pow10[decimals] + 0.5f;
+    while(decimals > 0 && scaled >= (float)sevseg_pow10[width]) {
+        decimals--;
+        scaled = a * (float)sevseg_pow10[decimals] + 0.5f;
+    }
+    if(scaled >= (float)sevseg_pow10[width]) {
+        return encodeSevSegChars("----");
+    }
+
+    return encodeSevSegFixed(neg ? -(int)scaled : (int)scaled, decimals);
+}//end encodeSevSegFloat()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        outputToSevSegFixed();
+		
+        int val                 Fixed-point value, e.g. 1234 for 12.34
+        unsigned int decimals   Digits of 'val' after the decimal point
+
+            Shows encodeSevSegFixed(val, decimals) in custom mode
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void outputToSevSegFixed(int val, unsigned int decimals) {
+
+    outputToSevSegFrame(encodeSevSegFixed(val, decimals));
+
+    return;
+}//end outputToSevSegFixed()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        outputToSevSegFloat();
+		
+        float val               Value to show
+
+            Shows encodeSevSegFloat(val) in custom mode
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void outputToSevSegFloat(float val) {
+
+    outputToSevSegFrame(encodeSevSegFloat(val));
+
+    return;
+}//end outputToSevSegFloat()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        outputToSevSegFrame();
+		
+        unsigned int frame      Pre-encoded SEVSEG_DATA word (see encodeSevSeg())
+
+            Shows a pre-encoded frame in custom mode. Re-sending the frame
+            already on the display costs no bus writes.
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void outputToSevSegFrame(unsigned int frame) {
+
+    periphLock(KLIB_PERIPH_SEVSEG);
+
+    enableSevSeg(1); // ensure sev-seg is in custom mode
+
+    // Send display data to display memory address
+    shadowWrite(SEVSEG_DATA_ADDR, frame);
+
+    periphUnlock(KLIB_PERIPH_SEVSEG);
+
+    return;
+}//end outputToSevSegFrame()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        outputToSevSegCustom();
+		
+        const char* str         Input string, only first 4 characters are used    
+            
+            Used to display strings on the seven-segment display
+            Any non-supported character will be blank. If a letter is only available
+            in either upper or lower case, both upper and lower case inputs will 
+            use the only available one.
+            
+        Written by Koby Miller
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void outputToSevSegCustom(const char* str) {
+
+    outputToSevSegFrame(encodeSevSeg(str));
+
+    return;
+}//end outputToSevSegCustom()
+
+// Replaces the bits under 'mask' in one digit (0-3) of the frame on the display.
+// 'hex' >= 0 asks for that hex digit in whichever mode the display is in,
+// otherwise 'bits' are custom-mode bits and segment changes need custom mode.
+static void patchSevSegDigit(byte digit, int hex, unsigned int bits, unsigned int mask) {
+
+    const unsigned int shift = (unsigned char)digit * 8;
+    unsigned int ctrl, frame;
+    unsigned char lut[16];
+    int c;
+
+    // no such digit, and wrapping it round would change one that exists
+    if((unsigned char)digit > 3) {
+        return;
+    }
+
+    periphLock(KLIB_PERIPH_SEVSEG);
+
+    ctrl = shadowRead(SEVSEG_CTRL_ADDR);
+    frame = shadowRead(SEVSEG_DATA_ADDR);
+
+    if(!(ctrl & 0b01)) {
+        // display off, whatever is in SEVSEG_DATA was never shown
+        ctrl = 0b11;
+        frame = 0xFFFFFFFF;
+    } else if(!(ctrl & 0b10) && hex < 0 && (mask & 0x7F)) {
+        // number mode to custom mode, each nibble becomes its glyph and points stay put
+        sevSegDigitTable(lut, 0);
+        for(c = 0; c < 32; c += 8) {
+            frame = (frame & ~(0x7Fu << c)) | ((unsigned int)(lut[(frame >> c) & 0xF] & 0x7F) << c);
+        }
+        ctrl = 0b11;
+    }
+
+    if(hex >= 0) {
+        if(ctrl & 0b10) {
+            bits = (unsigned char)~sevseg_glyph[(unsigned char)sevseg_hex_chars[hex & 0xF]];
+        } else {
+            bits = hex & 0xF;
+        }
+    }
+    frame = (frame & ~(mask << shift)) | ((bits & mask) << shift);
+
+    shadowWrite(SEVSEG_CTRL_ADDR, ctrl);
+    shadowWrite(SEVSEG_DATA_ADDR, frame);
+
+    periphUnlock(KLIB_PERIPH_SEVSEG);
+
+    return;
+}
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        setSevSegDigit();
+		
+        byte digit              Digit to change, 0 (rightmost) to 3, others are ignored
+        unsigned int val        Hexadecimal digit value, 0-F
+
+            Changes one digit and leaves the other three, and every
+            decimal point, as they are. Works in either mode: a number-mode
+            display gets the nibble, a custom-mode display gets the glyph.
+            If the display is off it starts from a blank custom-mode frame.
+            Patches the frame cached in the SEVSEG_DATA shadow register
+            and writes it once, or not at all if the digit already shows
+            'val'. A clock only needs setSevSegDigit(0, sec % 10) each
+            second.
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void setSevSegDigit(byte digit, unsigned int val) {
+
+    patchSevSegDigit(digit, val & 0xF, 0, 0x7F);
+
+    return;
+}//end setSevSegDigit()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        setSevSegChar();
+		
+        byte digit              Digit to change, 0 (rightmost) to 3, others are ignored
+        char ch                 Character to show, as in outputToSevSegCustom()
+
+            Like setSevSegDigit(), for any supported character. A
+            number-mode display is switched to custom mode first, keeping
+            what it showed.
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void setSevSegChar(byte digit, char ch) {
+
+    patchSevSegDigit(digit, -1, (unsigned char)~sevseg_glyph[(unsigned char)ch], 0x7F);
+
+    return;
+}//end setSevSegChar()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        clearSevSegDigit();
+		
+        byte digit              Digit to blank, 0 (rightmost) to 3, others are ignored
+
+            Blanks one digit, decimal point included. Like setSevSegChar(),
+            this switches a number-mode display to custom mode.
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void clearSevSegDigit(byte digit) {
+
+    patchSevSegDigit(digit, -1, 0xFF, 0xFF);
+
+    return;
+}//end clearSevSegDigit()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        setSevSegPoint();
+		
+        byte digit              Digit whose decimal point to change, 0 (rightmost) to 3, others are ignored
+        bool on                 1 lights the decimal point, 0 turns it off
+
+            Changes one decimal point in either mode, leaving the digits
+            as they are
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void setSevSegPoint(byte digit, bool on) {
+
+    patchSevSegDigit(digit, -1, on ? 0x00 : 0x80, 0x80); // decimal point is active low
+
+    return;
+}//end setSevSegPoint()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        outputToLEDs();
+		
+        int val       Value to push to the LEDs
+            
+            Used to display data on LEDs
+            
+        Written by Koby Miller
+        Last modified: January 30th, 2024
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void outputToLEDs(int val) {
+    
+    periphLock(KLIB_PERIPH_LEDS);
+
+    // Where LEDs overlap with '1' bits
+    val &= 0b1111111111;
+
+    // Write to LEDs' address
+	shadowWrite(LED_ADDR, val);
+    
+    periphUnlock(KLIB_PERIPH_LEDS);
+
+    return;
+}//end outputToLEDs()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        enableRGB();
+
+        unsigned int select     Binary number to enable each LED    
+
+            Used to enable RGB LEDs.
+            enableRGB(0b11) enables both LEDs
+            enableRGB(0b10) enables only second LED
+            
+        Written by Koby Miller
+        Last modified: February 14th, 2024
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void enableRGB(unsigned int select) {
+    
+    unsigned int rgb[2] = {bitIndex(select,0),bitIndex(select,1)}; //create array regarding the bit values of 'select' variable
+    byte c = 0; //iterator
+
+    periphLock(KLIB_PERIPH_RGB1);
+    periphLock(KLIB_PERIPH_RGB2);
+
+    for(c = 0; c < 3;c++) {
+        shadowWrite(RGB_EN_BASEADDR + c * 0x10, rgb[0]); 
+    }
+    
+    for(c = 0; c < 3;c++) {
+        shadowWrite(RGB_EN_BASEADDR + c * 0x10 + 0x30, rgb[1]);
+    }
+
+    periphUnlock(KLIB_PERIPH_RGB2);
+    periphUnlock(KLIB_PERIPH_RGB1);
+
+    return;
+}//end enableRGB()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        RGB gamma tables
+
+            rgb_gamma[] maps an 8-bit channel value straight to a PWM width
+            against the 2550 period: 2550 * (v / 255)^2.2.
+
+            rgb_bright_gamma[] is the same curve for brightness in Q0.16,
+            (i / 256)^2.2 * 65536, sampled every 256 steps and linearly
+            interpolated in between. A power law is multiplicative, so
+            gamma(channel * brightness) == gamma(channel) * gamma(brightness)
+            and one multiply combines the two.
+
+            Both were generated offline, nothing is computed at runtime.
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+static const unsigned short rgb_gamma[256] = {
+    0, 0, 0, 0, 0, 0, 1, 1, 1, 2, 2, 3, 3, 4, 4, 5,
+    6, 7, 7, 8, 9, 10, 12, 13, 14, 15, 17, 18, 20, 21, 23, 25,
+    27, 28, 30, 32, 34, 36, 39, 41, 43, 46, 48, 51, 53, 56, 59, 62,
+    65, 68, 71, 74, 77, 80, 84, 87, 91, 94, 98, 102, 106, 110, 114, 118,
+    122, 126, 130, 135, 139, 144, 148, 153, 158, 163, 168, 173, 178, 183, 188, 194,
+    199, 205, 210, 216, 222, 227, 233, 239, 245, 252, 258, 264, 271, 277, 284, 290,
+    297, 304, 311, 318, 325, 332, 340, 347, 355, 362, 370, 377, 385, 393, 401, 409,
+    417, 426, 434, 442, 451, 459, 468, 477, 486, 495, 504, 513, 522, 531, 541, 550,
+    560, 569, 579, 589, 599, 609, 619, 629, 640, 650, 661, 671, 682, 693, 703, 714,
+    725, 736, 748, 759, 770, 782, 794, 805, 817, 829, 841, 853, 865, 877, 890, 902,
+    915, 927, 940, 953, 966, 979, 992, 1005, 1018, 1032, 1045, 1059, 1072, 1086, 1100, 1114,
+    1128, 1142, 1156, 1171, 1185, 1200, 1214, 1229, 1244, 1259, 1274, 1289, 1304, 1319, 1335, 1350,
+    1366, 1382, 1397, 1413, 1429, 1445, 1462, 1478, 1494, 1511, 1527, 1544, 1561, 1578, 1595, 1612,
+    1629, 1646, 1664, 1681, 1699, 1716, 1734, 1752, 1770, 1788, 1806, 1824, 1843, 1861, 1880, 1899,
+    1917, 1936, 1955, 1974, 1993, 2013, 2032, 2052, 2071, 2091, 2111, 2131, 2151, 2171, 2191, 2211,
+    2232, 2252, 2273, 2293, 2314, 2335, 2356, 2377, 2399, 2420, 2441, 2463, 2484, 2506, 2528, 2550
+};
+
+static const unsigned int rgb_bright_gamma[257] = {
+    0, 0, 2, 4, 7, 11, 17, 24, 32, 41, 52, 64,
+    78, 93, 110, 128, 147, 168, 191, 215, 240, 267, 296, 327,
+    359, 392, 428, 465, 504, 544, 586, 630, 676, 723, 772, 823,
+    875, 930, 986, 1044, 1104, 1165, 1229, 1294, 1361, 1430, 1501, 1574,
+    1648, 1725, 1803, 1884, 1966, 2050, 2136, 2224, 2314, 2406, 2500, 2596,
+    2693, 2793, 2895, 2998, 3104, 3212, 3322, 3433, 3547, 3663, 3781, 3901,
+    4022, 4146, 4272, 4400, 4530, 4663, 4797, 4933, 5072, 5212, 5355, 5500,
+    5646, 5795, 5946, 6100, 6255, 6412, 6572, 6734, 6897, 7063, 7232, 7402,
+    7574, 7749, 7926, 8105, 8286, 8470, 8655, 8843, 9033, 9225, 9419, 9616,
+    9815, 10016, 10219, 10425, 10632, 10842, 11055, 11269, 11486, 11705, 11926, 12149,
+    12375, 12603, 12833, 13066, 13301, 13538, 13777, 14019, 14263, 14509, 14758, 15009,
+    15262, 15518, 15775, 16036, 16298, 16563, 16830, 17100, 17371, 17646, 17922, 18201,
+    18482, 18766, 19051, 19340, 19630, 19923, 20219, 20516, 20817, 21119, 21424, 21731,
+    22041, 22353, 22667, 22984, 23303, 23625, 23949, 24275, 24604, 24935, 25269, 25605,
+    25944, 26285, 26628, 26974, 27322, 27673, 28026, 28382, 28740, 29100, 29463, 29828,
+    30196, 30566, 30939, 31314, 31692, 32072, 32455, 32840, 33228, 33618, 34010, 34405,
+    34803, 35203, 35605, 36010, 36418, 36828, 37240, 37656, 38073, 38493, 38916, 39341,
+    39768, 40199, 40631, 41066, 41504, 41944, 42387, 42832, 43280, 43731, 44184, 44639,
+    45097, 45558, 46021, 46487, 46955, 47426, 47899, 48375, 48854, 49335, 49818, 50305,
+    50794, 51285, 51779, 52276, 52775, 53276, 53781, 54288, 54797, 55309, 55824, 56341,
+    56861, 57384, 57909, 58437, 58967, 59500, 60036, 60574, 61115, 61658, 62204, 62753,
+    63304, 63858, 64415, 64974, 65536
+};
+
+// Gamma-corrected brightness in Q0.16 (65536 is full) for a 0-65535 brightness
+static inline unsigned int rgbBrightGamma(unsigned short bright) {
+
+    const unsigned int idx = bright >> 8;
+    const unsigned int frac = bright & 0xFF;
+    const unsigned int lo = rgb_bright_gamma[idx];
+
+    // 65535 lands on 65280 + 255/256 of the last step, round the top step up to full
+    return lo + (((rgb_bright_gamma[idx + 1] - lo) * (frac + (frac >> 7))) >> 8);
+}
+
+// PWM width of channel 'c' (0 blue, 1 green, 2 red) of 'color' at gamma-corrected brightness 'gain'
+static inline unsigned int rgbWidth(unsigned int color, byte c, unsigned int gain) {
+    return (rgb_gamma[(color >> c * 8) & 0xFF] * gain) >> 16;
+}
+
+// 0.0 - 1.0 brightness to the 0 - 65535 outputToRGBFixed() takes, clamped
+static inline unsigned short rgbBrightFixed(float bright) {
+
+    if(bright <= 0.0f) {
+        return 0;
+    }
+    if(bright >= 1.0f) {
+        return 65535;
+    }
+
+    return (unsigned short)(bright * 65535.0f + 0.5f);
+}
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        outputToRGBFixed();
+		
+        unsigned int select         Picks which LED to send to 
+        unsigned int color          HEX color to display (0xNNNNNN)
+        unsigned short bright       0 - 65535 brightness (RGB_BRIGHT8() converts 0 - 255)
+
+            Integer-only, gamma-corrected RGB output. Channel values and
+            brightness both go through gamma 2.2 lookup tables, so low
+            levels look right, and no floating point is involved. Only
+            width registers whose value changed are written. Any nonzero
+            'select' picks the second LED, as in frameRGB().
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void outputToRGBFixed(unsigned int select, unsigned int color, unsigned short bright) {
+    
+    const unsigned int offset = (select != 0) * 0x30; // second LED for any nonzero 'select', never past its channels
+    const unsigned int gain = rgbBrightGamma(bright);
+    byte c = 0; // iterator
+    
+    periphLock(KLIB_PERIPH_RGB1 + (select != 0));
+
+    for(c = 0;c < 3;c++) {
+        // Constant period, only stored the first time (shadow registers)
+        // Offset pointer by 0x10 at a time for each color
+        shadowWrite(RGB_PERIOD_BASEADDR + 0x10 * c + offset, 2550); 
+
+        // Change width based on passed color HEX value
+        // Offset pointer by 0x10 at a time for each color
+        // Two least significant digits are blue, next two are green, two most significant are red
+        shadowWrite(RGB_WIDTH_BASEADDR + 0x10 * c + offset, rgbWidth(color, c, gain));
+    }
+
+    periphUnlock(KLIB_PERIPH_RGB1 + (select != 0));
+
+    return;
+}//end outputToRGBFixed()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        outputToRGB();
+		
+        unsigned int select         Picks which LED to send to 
+        unsigned int color          HEX color to display
+        float bright                0.0 - 1.0 value to determine brightness of LED
+
+            Used to display light on RGB LEDs
+            Converts 'bright' once and hands off to outputToRGBFixed()
+            
+        Written by Koby Miller
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void outputToRGB(unsigned int select, unsigned int color, float bright) {
+
+    outputToRGBFixed(select, color, rgbBrightFixed(bright));
+
+    return;
+}//end outputToRGB()
+
+// Fills every keyframe of 'a' from color(t), t running 0.0 - 1.0 over the table, at full brightness
+static void fillRGBAnimation(rgbAnimation* a, unsigned int select, unsigned long period_ms, bool loop,
+                             unsigned int (*color)(const void* arg, float t), const void* arg) {
+
+    unsigned int step;
+    unsigned int rgb;
+    byte c;
+
+    for(step = 0; step < RGB_ANIM_STEPS; step++) {
+        // looping tables never reach t = 1.0, that's keyframe 0 of the next pass
+        rgb = color(arg, (float)step / (loop ? RGB_ANIM_STEPS : RGB_ANIM_STEPS - 1));
+        for(c = 0; c < 3; c++) {
+            a->width[step][(int)c] = rgb_gamma[(rgb >> c * 8) & 0xFF];
+        }
+    }
+
+    if(period_ms == 0) {
+        period_ms = 1;
+    }
+
+    a->select = select != 0; // LED 2 for any nonzero 'select', like outputToRGBFixed()
+    a->period_ms = period_ms;
+    a->rate = ((unsigned long long)RGB_ANIM_STEPS << 32) / period_ms;
+    a->loop = loop;
+    a->started = false;
+    a->done = false;
+
+    return;
+}
+
+// Per-channel blend of two HEX colors, t from 0.0 (a) to 1.0 (b)
+static unsigned int lerpColor(unsigned int a, unsigned int b, float t) {
+
+    unsigned int out = 0;
+    int from, to;
+    byte c;
+
+    for(c = 0; c < 3; c++) {
+        from = (a >> c * 8) & 0xFF;
+        to = (b >> c * 8) & 0xFF;
+        out |= (unsigned int)(from + (to - from) * t + 0.5f) << (c * 8);
+    }
+
+    return out;
+}
+
+typedef struct {
+    unsigned int from, to;
+    bool eased;
+} rgbFadeArgs;
+
+static unsigned int fadeColor(const void* arg, float t) {
+
+    const rgbFadeArgs* f = arg;
+
+    if(f->eased) {
+        t = t * t * (3.0f - 2.0f * t); // smoothstep
+    }
+
+    return lerpColor(f->from, f->to, t);
+}
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        animateRGBFade();
+		
+        rgbAnimation* a             Animation to set up
+        unsigned int select         Picks which LED to animate
+        unsigned int from           HEX color to start at
+        unsigned int to             HEX color to end at
+        unsigned long duration_ms   Length of the fade
+        bool eased                  0 for a linear fade, 1 to ease in and out
+
+            Precomputes a one-shot fade between two colors. The first
+            tickRGBAnimation() starts it.
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void animateRGBFade(rgbAnimation* a, unsigned int select, unsigned int from, unsigned int to, unsigned long duration_ms, bool eased) {
+
+    const rgbFadeArgs f = {from, to, eased};
+
+    fillRGBAnimation(a, select, duration_ms, false, fadeColor, &f);
+
+    return;
+}//end animateRGBFade()
+
+static unsigned int breatheColor(const void* arg, float t) {
+
+    const unsigned int color = *(const unsigned int*)arg;
+
+    // triangle 0 -> 1 -> 0, smoothstepped, stays within 1% of a raised cosine without libm
+    t = (t < 0.5f) ? 2.0f * t : 2.0f - 2.0f * t;
+
+    return lerpColor(0, color, t * t * (3.0f - 2.0f * t));
+}
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        animateRGBBreathe();
+		
+        rgbAnimation* a             Animation to set up
+        unsigned int select         Picks which LED to animate
+        unsigned int color          HEX color to breathe
+        unsigned long period_ms     Time of one full breath
+
+            Precomputes a looping breathing effect: brightness rises and
+            falls along a smoothed triangle (close to a raised cosine),
+            gamma-corrected like outputToRGBFixed().
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void animateRGBBreathe(rgbAnimation* a, unsigned int select, unsigned int color, unsigned long period_ms) {
+
+    fillRGBAnimation(a, select, period_ms, true, breatheColor, &color);
+
+    return;
+}//end animateRGBBreathe()
+
+typedef struct {
+    const unsigned int* colors;
+    unsigned int count;
+} rgbCycleArgs;
+
+static unsigned int cycleColor(const void* arg, float t) {
+
+    const rgbCycleArgs* cyc = arg;
+    const float pos = t * cyc->count;
+    const unsigned int i = (unsigned int)pos;
+
+    return lerpColor(cyc->colors[i % cyc->count], cyc->colors[(i + 1) % cyc->count], pos - i);
+}
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        animateRGBCycle();
+		
+        rgbAnimation* a             Animation to set up
+        unsigned int select         Picks which LED to animate
+        const unsigned int* colors  HEX colors to cycle through
+        unsigned int count          Number of colors, at least 1
+        unsigned long step_ms       Time to fade from one color to the next
+
+            Precomputes a looping cross-fade through a list of colors,
+            ending back on the first one. With no colors the animation
+            is finished from the start and never touches the LED
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void animateRGBCycle(rgbAnimation* a, unsigned int select, const unsigned int* colors, unsigned int count, unsigned long step_ms) {
+
+    const rgbCycleArgs cyc = {colors, count};
+
+    if(count == 0) {
+        a->done = true; // nothing to read colors from
+        return;
+    }
+
+    fillRGBAnimation(a, select, step_ms * cyc.count, true, cycleColor, &cyc);
+
+    return;
+}//end animateRGBCycle()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        tickRGBAnimation();
+		
+        rgbAnimation* a             Animation to advance
+        unsigned long now           Current time from getMillis()
+
+            Non-blocking. Looks up the keyframe for 'now' (one multiply,
+            no division while inside a pass) and writes only the width
+            registers that changed. The cost per tick doesn't depend on
+            the effect, and nothing is allocated.
+
+            Returns 1 while the animation runs, 0 once a fade has finished.
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+bool tickRGBAnimation(rgbAnimation* a, unsigned long now) {
+
+    const unsigned int offset = a->select * 0x30; // offset address based on 'select' variable
+    unsigned long elapsed;
+    unsigned int step;
+    byte c;
+
+    if(a->done) {
+        return false;
+    }
+
+    if(!a->started) {
+        a->started = true;
+        a->start_ms = now;
+    }
+
+    elapsed = now - a->start_ms;
+    if(elapsed >= a->period_ms) {
+        if(a->loop) {
+            // only divides when a pass wraps
+            a->start_ms += elapsed - elapsed % a->period_ms;
+            elapsed %= a->period_ms;
+            step = (elapsed * a->rate) >> 32;
+        } else {
+            a->done = true;
+            step = RGB_ANIM_STEPS - 1; // land exactly on the final color
+        }
+    } else {
+        step = (elapsed * a->rate) >> 32;
+    }
+    step &= RGB_ANIM_STEPS - 1;
+
+    periphLock(KLIB_PERIPH_RGB1 + (a->select != 0));
+
+    for(c = 0; c < 3; c++) {
+        shadowWrite(RGB_PERIOD_BASEADDR + 0x10 * c + offset, 2550);
+        shadowWrite(RGB_WIDTH_BASEADDR + 0x10 * c + offset, a->width[step][(int)c]);
+    }
+
+    periphUnlock(KLIB_PERIPH_RGB1 + (a->select != 0));
+
+    return !a->done;
+}//end tickRGBAnimation()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        initOutputQueue();
+		
+        outputQueue* q              Queue to set up
+        unsigned int period_us      Time between flushes of startOutputThread(), 0 for OUTPUT_PERIOD_US
+
+            Asynchronous output. Any number of threads hand commands to
+            queueLEDs(), queueSevSeg(), queueSevSegCustom() and queueRGB()
+            and return at once, without touching the bus. A single I/O
+            thread drains them with flushOutputQueue(): of all the commands
+            queued for one peripheral since the last flush only the newest
+            is converted and written (last writer wins), so the bus sees at
+            most one update per peripheral per flush, however fast the
+            producers run.
+
+            The queue is lock-free and never fills up: each peripheral has
+            one slot that producers overwrite with a single atomic exchange,
+            so they never wait, neither for each other nor for the I/O
+            thread, and the newest command is never turned away. A command
+            that replaces one the I/O thread hasn't written yet counts as
+            coalesced.
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void initOutputQueue(outputQueue* q, unsigned int period_us) {
+
+    int p;
+
+    for(p = 0; p <= KLIB_PERIPH_RGB2; p++) {
+        atomic_init(&q->latest[p].cmd, 0);
+        atomic_init(&q->latest[p].coalesced, 0);
+    }
+
+    atomic_flag_clear(&q->flushing);
+    atomic_init(&q->written, 0);
+    q->period_us = period_us ? period_us : OUTPUT_PERIOD_US;
+    atomic_init(&q->running, false);
+
+    return;
+}//end initOutputQueue()
+
+// A queued command packed into one word: value, bright, type and arg from the low bits up, pending on top
+#define OUTPUT_PENDING (1ULL << 63)
+
+// Producer side of the output queue, swaps the command into its peripheral's slot and never waits
+static void queueOutput(outputQueue* q, int periph, byte type, byte arg, unsigned int value, unsigned short bright) {
+
+    const unsigned long long cmd = OUTPUT_PENDING | (unsigned long long)value | (unsigned long long)bright << 32
+                                 | (unsigned long long)type << 48 | (unsigned long long)arg << 56;
+
+    // last writer wins: the older command, if the I/O thread hadn't taken it yet, is never written
+    if(atomic_exchange_explicit(&q->latest[periph].cmd, cmd, memory_order_relaxed) & OUTPUT_PENDING) {
+        atomic_fetch_add_explicit(&q->latest[periph].coalesced, 1, memory_order_relaxed);
+    }
+
+    return;
+}
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        queueLEDs();
+		
+        outputQueue* q              Queue to submit to
+        int val                     Value for outputToLEDs()
+
+            Safe from any thread, never blocks.
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void queueLEDs(outputQueue* q, int val) {
+    queueOutput(q, KLIB_PERIPH_LEDS, OUTPUT_CMD_LEDS, 0, (unsigned int)val, 0);
+}//end queueLEDs()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        queueSevSeg();
+		
+        outputQueue* q              Queue to submit to
+        int val                     Value for outputToSevSeg()
+        byte mode                   Mode for outputToSevSeg()
+
+            Safe from any thread, never blocks. The digits are only worked
+            out at flush time, and not at all if a newer command replaces it.
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void queueSevSeg(outputQueue* q, int val, byte mode) {
+    queueOutput(q, KLIB_PERIPH_SEVSEG, OUTPUT_CMD_SEVSEG, mode, (unsigned int)val, 0);
+}//end queueSevSeg()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        queueSevSegCustom();
+		
+        outputQueue* q              Queue to submit to
+        const char* str             Up to 4 characters for outputToSevSegCustom()
+
+            Safe from any thread, never blocks. Shares the seven-segment
+            slot with queueSevSeg(), so the newer of the two wins.
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void queueSevSegCustom(outputQueue* q, const char* str) {
+
+    unsigned int packed = 0;
+    int c;
+
+    for(c = 0; c < 4 && str[c] != '\0'; c++) {
+        packed |= (unsigned int)(unsigned char)str[c] << (c * 8);
+    }
+
+    queueOutput(q, KLIB_PERIPH_SEVSEG, OUTPUT_CMD_SEVSEG_CUSTOM, 0, packed, 0);
+
+    return;
+}//end queueSevSegCustom()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        queueRGB();
+		
+        outputQueue* q              Queue to submit to
+        unsigned int select         Picks which LED to send to
+        unsigned int color          HEX color to display (0xNNNNNN)
+        unsigned short bright       0 - 65535 brightness, as for outputToRGBFixed()
+
+            Safe from any thread, never blocks. Each RGB LED coalesces
+            on its own.
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void queueRGB(outputQueue* q, unsigned int select, unsigned int color, unsigned short bright) {
+    queueOutput(q, select ? KLIB_PERIPH_RGB2 : KLIB_PERIPH_RGB1, OUTPUT_CMD_RGB, select != 0, color, bright);
+}//end queueRGB()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        flushOutputQueue();
+		
+        outputQueue* q              Queue to drain
+
+            Takes the newest command of each peripheral out of its slot
+            and writes it. Normally run by startOutputThread(); on
+            bare-metal call it from the main loop. A call made while
+            another flush is running returns 0 right away.
+            Returns the number of commands written.
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+unsigned int flushOutputQueue(outputQueue* q) {
+
+    unsigned long long cmd;
+    unsigned int value;
+    unsigned int written = 0;
+    byte arg;
+    char chars[4];
+    int p, c;
+
+    if(atomic_flag_test_and_set_explicit(&q->flushing, memory_order_acquire)) {
+        return 0;
+    }
+
+    for(p = 0; p <= KLIB_PERIPH_RGB2; p++) {
+        // a cheap look first, so idle peripherals don't cost a read-modify-write
+        if(!(atomic_load_explicit(&q->latest[p].cmd, memory_order_relaxed) & OUTPUT_PENDING)) {
+            continue;
+        }
+
+        // keeps the command but clears pending, a producer swapping in meanwhile just makes it pending again
+        cmd = atomic_fetch_and_explicit(&q->latest[p].cmd, ~OUTPUT_PENDING, memory_order_relaxed);
+        value = (unsigned int)cmd;
+        arg = (byte)((cmd >> 56) & 0x7F);
+
+        switch((cmd >> 48) & 0xFF) {
+            case OUTPUT_CMD_LEDS:
+                outputToLEDs((int)value);
+                break;
+            case OUTPUT_CMD_SEVSEG:
+                outputToSevSeg((int)value, arg);
+                break;
+            case OUTPUT_CMD_SEVSEG_CUSTOM:
+                for(c = 0; c < 4; c++) {
+                    chars[c] = (char)(value >> (c * 8));
+                }
+                outputToSevSegFrame(encodeSevSegChars(chars));
+                break;
+            case OUTPUT_CMD_RGB:
+                outputToRGBFixed(arg, value, (unsigned short)(cmd >> 32));
+                break;
+        }
+        written++;
+    }
+
+    atomic_fetch_add_explicit(&q->written, written, memory_order_relaxed);
+    atomic_flag_clear_explicit(&q->flushing, memory_order_release);
+
+    return written;
+}//end flushOutputQueue()
+
+#ifdef __linux__
+// I/O thread, wakes on absolute deadlines like the input sampler
+static void* outputThread(void* arg) {
+
+    outputQueue* q = arg;
+    struct timespec next;
+
+    clock_gettime(CLOCK_MONOTONIC, &next);
+
+    while(atomic_load_explicit(&q->running, memory_order_relaxed)) {
+        flushOutputQueue(q);
+
+        next.tv_nsec += (long)q->period_us * 1000;
+        while(next.tv_nsec >= 1000000000L) {
+            next.tv_nsec -= 1000000000L;
+            next.tv_sec++;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+    }
+
+    return NULL;
+}
+#endif
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        startOutputThread();
+		
+        outputQueue* q              Queue to serve
+
+            Starts the I/O thread, calling flushOutputQueue() every period_us.
+            Returns 0 on success, -1 if the thread could not be started
+            (always on bare-metal).
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+int startOutputThread(outputQueue* q) {
+
+#ifdef __linux__
+    atomic_store(&q->running, true);
+
+    if(pthread_create(&q->thread, NULL, outputThread, q) != 0) {
+        atomic_store(&q->running, false);
+        return -1;
+    }
+
+    return 0;
+#else
+    (void)q;
+    return -1;
+#endif
+}//end startOutputThread()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        stopOutputThread();
+		
+        outputQueue* q              Queue to stop serving
+
+            Stops and joins the I/O thread, then flushes whatever was
+            still pending so the last state always reaches the hardware
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void stopOutputThread(outputQueue* q) {
+
+#ifdef __linux__
+    if(atomic_exchange(&q->running, false)) {
+        pthread_join(q->thread, NULL);
+    }
+#endif
+
+    flushOutputQueue(q);
+
+    return;
+}//end stopOutputThread()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        getOutputQueueStats();
+		
+        outputQueue* q              Queue to query
+        outputQueueStats* s         Filled with the counters
+
+            The coalescing ratio is submitted / written: how many commands
+            the producers issued for every one that cost bus writes.
+            Safe to call while the queue is in use.
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void getOutputQueueStats(outputQueue* q, outputQueueStats* s) {
+
+    int p;
+
+    s->written = atomic_load_explicit(&q->written, memory_order_relaxed);
+    s->coalesced = 0;
+    s->pending = 0;
+
+    for(p = 0; p <= KLIB_PERIPH_RGB2; p++) {
+        s->coalesced += atomic_load_explicit(&q->latest[p].coalesced, memory_order_relaxed);
+        s->pending += (atomic_load_explicit(&q->latest[p].cmd, memory_order_relaxed) & OUTPUT_PENDING) != 0;
+    }
+
+    // every command was either written, replaced, or is still waiting
+    s->submitted = s->written + s->coalesced + s->pending;
+    s->ratio = s->written ? (float)s->submitted / s->written : 0.0f;
+
+    return;
+}//end getOutputQueueStats()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        initDisplaySink();
+		
+        displaySink* d          Sink to set up
+        unsigned int max_hz     Most renders per second, 0 for DISPLAY_SINK_HZ
+
+            Rate-limited seven-segment and LED output for loops that
+            produce values far faster than anyone can read them. The
+            sink*() functions only remember the newest value; at most
+            max_hz times a second it is converted (digits, glyphs) and
+            written. Values replaced before their frame cost nothing
+            beyond the store into the sink and one getNanos() call.
+
+            Single-threaded, like the marquee. Threads share the display
+            through the output queue (initOutputQueue()) instead.
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void initDisplaySink(displaySink* d, unsigned int max_hz) {
+
+    d->frame_ns = 1000000000ULL / (max_hz ? max_hz : DISPLAY_SINK_HZ);
+    d->next_ns = 0; // the first value shows immediately
+    d->sevseg_dirty = false;
+    d->led_dirty = false;
+    d->submitted = 0;
+    d->rendered = 0;
+
+    return;
+}//end initDisplaySink()
+
+// Counts a submission and renders if a frame is due
+static inline bool sinkSubmit(displaySink* d) {
+
+    d->submitted++;
+
+    return flushDisplaySink(d, false);
+}
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        sinkSevSeg();
+		
+        displaySink* d          Sink to submit to
+        int val                 Value for outputToSevSeg()
+        byte mode               Mode for outputToSevSeg()
+
+            Keeps the value for the next frame and renders right away if
+            a frame is due. Returns 1 if the display was updated.
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+bool sinkSevSeg(displaySink* d, int val, byte mode) {
+
+    d->sevseg_val = val;
+    d->sevseg_mode = mode;
+    d->sevseg_custom = false;
+    d->sevseg_dirty = true;
+
+    return sinkSubmit(d);
+}//end sinkSevSeg()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        sinkSevSegCustom();
+		
+        displaySink* d          Sink to submit to
+        const char* str         Up to 4 characters for outputToSevSegCustom()
+
+            As sinkSevSeg(), replacing any pending number
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+bool sinkSevSegCustom(displaySink* d, const char* str) {
+
+    int c;
+
+    // same padding as encodeSevSeg(), conversion waits for the render
+    for(c = 0; c < 4 && str[c] != '\0'; c++) {
+        d->sevseg_chars[c] = str[c];
+    }
+    for(; c < 4; c++) {
+        d->sevseg_chars[c] = '\0';
+    }
+    d->sevseg_custom = true;
+    d->sevseg_dirty = true;
+
+    return sinkSubmit(d);
+}//end sinkSevSegCustom()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        sinkLEDs();
+		
+        displaySink* d          Sink to submit to
+        int val                 Value for outputToLEDs()
+
+            Keeps the value for the next frame and renders right away if
+            a frame is due. Returns 1 if the display was updated.
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+bool sinkLEDs(displaySink* d, int val) {
+
+    d->led_val = val;
+    d->led_dirty = true;
+
+    return sinkSubmit(d);
+}//end sinkLEDs()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        flushDisplaySink();
+		
+        displaySink* d          Sink to render
+        bool force              Render now, even if the frame isn't due
+
+            Renders pending values once a frame is due. The sink*()
+            functions already do this, so call it from an idle loop to let
+            the last value of a burst land on time, or with 'force' when the
+            value must show immediately (e.g. before exiting).
+            Returns 1 if anything was written.
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+bool flushDisplaySink(displaySink* d, bool force) {
+
+    unsigned long long now;
+
+    if(!d->sevseg_dirty && !d->led_dirty) {
+        return false;
+    }
+
+    // read on every call, so a producer that slows down after a burst still renders on time
+    now = getNanos();
+    if(!force && now < d->next_ns) {
+        return false;
+    }
+
+    // keep the cadence, unless a whole frame was missed
+    d->next_ns = (now - d->next_ns < d->frame_ns) ? d->next_ns + d->frame_ns : now + d->frame_ns;
+
+    if(d->sevseg_dirty) {
+        if(d->sevseg_custom) {
+            outputToSevSegFrame(encodeSevSegChars(d->sevseg_chars));
+        } else {
+            outputToSevSeg(d->sevseg_val, d->sevseg_mode);
+        }
+        d->sevseg_dirty = false;
+        d->rendered++;
+    }
+    if(d->led_dirty) {
+        outputToLEDs(d->led_val);
+        d->led_dirty = false;
+        d->rendered++;
+    }
+
+    return true;
+}//end flushDisplaySink()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        getDisplaySinkStats();
+		
+        displaySink* d              Sink to query
+        unsigned long* submitted    Values handed to the sink
+        unsigned long* rendered     Values converted and written
+
+            Either pointer may be NULL. submitted - rendered values never
+            reached the display, nor cost a conversion or a bus write.
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void getDisplaySinkStats(displaySink* d, unsigned long* submitted, unsigned long* rendered) {
+
+    if(submitted != NULL) {
+        *submitted = d->submitted;
+    }
+    if(rendered != NULL) {
+        *rendered = d->rendered;
+    }
+
+    return;
+}//end getDisplaySinkStats()
+
+// Bit of PMOD B pin 'pin' (PMODB_PIN()) in DIR_2, OE_2, DATA_2 and DATA_2_RO
+#define PMODB_BIT(pin) (1u << (7 + (pin)))
+
+// Steps the simulated I2C slave through the bus levels in 'pins', returns true while it pulls SDA low
+static bool simI2cSlave(unsigned int pins) {
+
+    const bool scl = (pins >> klib_sim_i2c.scl) & 1;
+    const bool sda = (pins >> klib_sim_i2c.sda) & 1;
+
+    if(scl && klib_sim_i2c.scl_prev && sda != klib_sim_i2c.sda_prev) {
+        // SDA falling while SCL is high is a START, rising is a STOP
+        klib_sim_i2c.bit = sda ? -1 : 0;
+        klib_sim_i2c.shift = 0;
+        klib_sim_i2c.first = true;
+        klib_sim_i2c.ours = false;
+        klib_sim_i2c.ack = false;
+    } else if(scl && !klib_sim_i2c.scl_prev && klib_sim_i2c.bit >= 0 && klib_sim_i2c.bit < 8) {
+        klib_sim_i2c.shift = (uint8_t)((klib_sim_i2c.shift << 1) | sda);
+        klib_sim_i2c.bit++;
+    } else if(!scl && klib_sim_i2c.scl_prev && klib_sim_i2c.bit == 8) {
+        // byte complete, acknowledge it through the next clock
+        if(klib_sim_i2c.first) {
+            klib_sim_i2c.ours = (klib_sim_i2c.shift >> 1) == klib_sim_i2c.addr;
+            klib_sim_i2c.reading = klib_sim_i2c.shift & 1;
+            klib_sim_i2c.first = false;
+        } else if(klib_sim_i2c.ours && klib_sim_i2c.count < SIM_I2C_BYTES) {
+            klib_sim_i2c.rx[klib_sim_i2c.count++] = klib_sim_i2c.shift;
+        }
+        klib_sim_i2c.ack = klib_sim_i2c.ours;
+        klib_sim_i2c.bit = 9;
+    } else if(!scl && klib_sim_i2c.scl_prev && klib_sim_i2c.bit == 9) {
+        // ACK clock over, a read leaves SDA to the master until the STOP
+        klib_sim_i2c.ack = false;
+        klib_sim_i2c.bit = (klib_sim_i2c.ours && !klib_sim_i2c.reading) ? 0 : -1;
+        klib_sim_i2c.shift = 0;
+    }
+
+    klib_sim_i2c.scl_prev = scl;
+    klib_sim_i2c.sda_prev = sda;
+
+    return klib_sim_i2c.ack;
+}
+
+// Simulated backend: recomputes what DATA_2_RO shows on PMOD B from the outputs, wires and I2C slave
+static void simPmodUpdate() {
+
+    unsigned int drive, level, pins;
+    int p;
+
+    if(klib_backend != KLIB_BACKEND_SIM || !klib_sim_wired) {
+        return;
+    }
+
+    // this is the simulated pin hardware, not bus traffic, so it skips mmioRead()/mmioWrite()
+    drive = *klibReg(DIR_2) & *klibReg(OE_2);
+    level = (((*klibReg(DATA_2) & drive) | ~drive) >> 7) & 0xFF; // undriven pins are pulled up
+    pins = level;
+
+    for(p = 0; p < 8; p++) {
+        if(klib_sim_wire[p] != 0xFF && !(drive & PMODB_BIT(p))) {
+            pins = (pins & ~(1u << p)) | (((level >> klib_sim_wire[p]) & 1) << p);
+        }
+    }
+
+    if(klib_sim_i2c.scl != 0xFF && simI2cSlave(pins)) {
+        pins &= ~(1u << klib_sim_i2c.sda); // open drain, a pulled-down line reads low
+    }
+
+    *klibReg(DATA_2_RO) = (*klibReg(DATA_2_RO) & ~(0xFFu << 7)) | (pins << 7);
+
+    return;
+}
+
+// Stores a ready-made MASK_DATA_2_LSW word
+static inline void pmodStore(unsigned int word) {
+
+    unsigned int mask;
+
+    mmioWrite(MASK_DATA_2_LSW, word);
+
+    // the simulated register file has no MASK_DATA logic, apply it by hand
+    if(klib_backend == KLIB_BACKEND_SIM) {
+        mask = ~(word >> 16) & 0xFFFF;
+        *klibReg(DATA_2) = (*klibReg(DATA_2) & ~mask) | (word & mask);
+        simPmodUpdate();
+    }
+
+    return;
+}
+
+// Sets the bank 2 pins in 'mask' to 'bits' with one store; pins outside 'mask' are untouched
+static inline void pmodMaskedWrite(unsigned int mask, unsigned int bits) {
+
+    // upper half selects the pins to leave alone, lower half is the new data
+    pmodStore(((~mask & 0xFFFF) << 16) | (bits & mask));
+
+    return;
+}
+
+// Stores a ready-made DIR_2 word
+static inline void pmodDirStore(unsigned int word) {
+
+    shadowWrite(DIR_2, word);
+    simPmodUpdate();
+
+    return;
+}
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        setupPmod();
+		
+        bool io             read (0) or write (1)
+        bool row            top (0) or bottom (1) row
+
+            Enables the mode of PMOD B
+        
+        Written by Koby Miller
+        Originally written by Dr. Jacob Murray
+        Last modified: February 9th, 2024
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void setupPmod(bool io, bool row) {
+
+    periphLock(KLIB_PERIPH_PMOD);
+
+    if(row == 0) {
+        if(io == 0) {   // bits 7-10 of DIR_2 for top row should be 0000 for input
+            shadowWrite(DIR_2, shadowRead(DIR_2) & ~PMODB_TOP_MASK);
+            shadowWrite(OE_2, shadowRead(OE_2) & ~PMODB_TOP_MASK);
+
+        } else {        // bits 7-10 of DIR_2 for top row should be 1111 for output
+            shadowWrite(DIR_2, shadowRead(DIR_2) | PMODB_TOP_MASK);
+            shadowWrite(OE_2, shadowRead(OE_2) | PMODB_TOP_MASK);
+
+        }   
+
+    } else {
+        if(io == 0) {   // bits 11-14 of DIR_2 for bopttom row should be 0000 for input
+            shadowWrite(DIR_2, shadowRead(DIR_2) & ~PMODB_BOTTOM_MASK);
+            shadowWrite(OE_2, shadowRead(OE_2) & ~PMODB_BOTTOM_MASK);
+
+        } else {        // bits 11-14 of DIR_2 for bottom row should be 1111 for output
+            shadowWrite(DIR_2, shadowRead(DIR_2) | PMODB_BOTTOM_MASK);
+            shadowWrite(OE_2, shadowRead(OE_2) | PMODB_BOTTOM_MASK);
+            
+        }
+    }
+
+    klib_pmod_dir[row != 0] = (io != 0); // pmodRead()/pmodWrite() skip setup while this holds
+    simPmodUpdate();
+
+    periphUnlock(KLIB_PERIPH_PMOD);
+
+    return;
+}
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        pmodRead();
+		
+        bool row            top (0) or bottom (1) row
+
+            Returns a 4-bit value from the PMOD B row selected
+            Direction is only reprogrammed when the row isn't an input yet
+        
+        Written by Koby Miller
+        Originally written by Dr. Jacob Murray
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+unsigned int pmodRead(bool row) {
+
+    unsigned int data;
+
+    periphLock(KLIB_PERIPH_PMOD);
+
+    if(klib_pmod_dir[row != 0] != 0) {
+        setupPmod(0, row); // ensure input mode, only when the row isn't already
+    }
+
+    data = pmodReadFast(row);
+
+    periphUnlock(KLIB_PERIPH_PMOD);
+
+    return data;
+}
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        pmodWrite();
+		
+        bool row                top (0) or bottom (1) row
+        unsigned int data       data to be written to the selected PMOD B row       
+
+            Writes a 4-bit value to the PMOD B row selected
+            Direction is only reprogrammed when the row isn't an output yet
+        
+        Written by Koby Miller
+        Originally written by Dr. Jacob Murray
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void pmodWrite(bool row, unsigned int data) {
+
+    periphLock(KLIB_PERIPH_PMOD);
+
+    if(klib_pmod_dir[row != 0] != 1) {
+        setupPmod(1, row); // ensure output mode, only when the row isn't already
+    }
+
+    pmodWriteFast(row, data);
+
+    periphUnlock(KLIB_PERIPH_PMOD);
+
+    return;
+}
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        pmodReadFast();
+		
+        bool row            top (0) or bottom (1) row
+
+            Returns a 4-bit value from the PMOD B row selected, assuming
+            the row is already an input. A single load.
+        
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+unsigned int pmodReadFast(bool row) {
+
+    // actual magic from Dr. Murray I guess
+    // mask off and shift to appropriate bit position, top row is bits 7-10, bottom row is bits 11-14
+    return (mmioRead(DATA_2_RO) >> (row ? 11 : 7)) & 0xF;
+}
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        pmodWriteFast();
+		
+        bool row                top (0) or bottom (1) row
+        unsigned int data       data to be written to the selected PMOD B row
+
+            Writes a 4-bit value to the PMOD B row selected, assuming the
+            row is already an output. A single store to MASK_DATA_2_LSW,
+            which leaves the other pins of the bank alone, so it is safe
+            to call from several threads without a lock.
+        
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void pmodWriteFast(bool row, unsigned int data) {
+
+    pmodMaskedWrite(row ? PMODB_BOTTOM_MASK : PMODB_TOP_MASK, data << (row ? 11 : 7));
+
+    return;
+}
+
+#define PMOD_BURST_CHUNK 64 // register words built ahead of each run of stores/loads
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        pmodWriteBurst();
+		
+        bool row                    top (0) or bottom (1) row
+        const uint8_t* nibbles      4-bit values to write, in order
+        size_t n                    Number of values
+
+            Streams a buffer out of a PMOD B row for bit-banged protocols.
+            Direction is set once, the MASK_DATA_2_LSW words are built a
+            chunk at a time and then stored back to back, so the pins
+            toggle as fast as the bus takes the stores.
+        
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void pmodWriteBurst(bool row, const uint8_t* nibbles, size_t n) {
+
+    const unsigned int mask = row ? PMODB_BOTTOM_MASK : PMODB_TOP_MASK;
+    const unsigned int shift = row ? 11 : 7;
+    const unsigned int keep = (~mask & 0xFFFF) << 16; // MASK_DATA upper half, every other pin
+    volatile unsigned int* const reg = klibReg(MASK_DATA_2_LSW);
+    unsigned int words[PMOD_BURST_CHUNK];
+    size_t done, chunk, c;
+
+    periphLock(KLIB_PERIPH_PMOD);
+
+    if(klib_pmod_dir[row != 0] != 1) {
+        setupPmod(1, row); // ensure output mode
+    }
+
+    for(done = 0; done < n; done += chunk) {
+        chunk = (n - done < PMOD_BURST_CHUNK) ? n - done : PMOD_BURST_CHUNK;
+
+        for(c = 0; c < chunk; c++) {
+            words[c] = keep | (((unsigned int)nibbles[done + c] << shift) & mask);
+        }
+        for(c = 0; c < chunk; c++) {
+            *reg = words[c];
+        }
+        mmioBurstWrite(MASK_DATA_2_LSW, chunk);
+
+        // the simulated register file has no MASK_DATA logic, mirror where the chunk left the pins
+        if(klib_backend == KLIB_BACKEND_SIM) {
+            *klibReg(DATA_2) = (*klibReg(DATA_2) & ~mask) | (words[chunk - 1] & mask);
+            simPmodUpdate();
+        }
+    }
+
+    periphUnlock(KLIB_PERIPH_PMOD);
+
+    return;
+}//end pmodWriteBurst()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        pmodReadBurst();
+		
+        bool row                    top (0) or bottom (1) row
+        uint8_t* out                Filled with n 4-bit values
+        size_t n                    Number of values
+
+            Samples a PMOD B row n times with back-to-back loads of
+            DATA_2_RO, after setting the direction once
+        
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void pmodReadBurst(bool row, uint8_t* out, size_t n) {
+
+    const unsigned int shift = row ? 11 : 7;
+    volatile unsigned int* const reg = klibReg(DATA_2_RO);
+    unsigned int words[PMOD_BURST_CHUNK];
+    size_t done, chunk, c;
+
+    periphLock(KLIB_PERIPH_PMOD);
+
+    if(klib_pmod_dir[row != 0] != 0) {
+        setupPmod(0, row); // ensure input mode
+    }
+
+    for(done = 0; done < n; done += chunk) {
+        chunk = (n - done < PMOD_BURST_CHUNK) ? n - done : PMOD_BURST_CHUNK;
+
+        for(c = 0; c < chunk; c++) {
+            words[c] = *reg;
+        }
+        mmioBurstRead(DATA_2_RO, chunk);
+        for(c = 0; c < chunk; c++) {
+            out[done + c] = (words[c] >> shift) & 0xF;
+        }
+    }
+
+    periphUnlock(KLIB_PERIPH_PMOD);
+
+    return;
+}//end pmodReadBurst()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        initPmodCapture();
+		
+        pmodCapture* cap            Capture to set up
+        unsigned int capacity       Number of runs (pin changes) the ring holds
+
+            Preallocates the capture ring and sets PMOD_TRIGGER_NONE.
+            Returns 0 on success, -1 if memory ran out.
+        
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+int initPmodCapture(pmodCapture* cap, unsigned int capacity) {
+
+    cap->runs = malloc(capacity * sizeof(pmodRun));
+    if(cap->runs == NULL || capacity == 0) {
+        free(cap->runs);
+        cap->runs = NULL;
+        return -1;
+    }
+
+    cap->capacity = capacity;
+    cap->head = 0;
+    cap->count = 0;
+    cap->samples = 0;
+    cap->trigger_sample = 0;
+    cap->ns = 0;
+    setPmodTrigger(cap, PMOD_TRIGGER_NONE, 0, 0);
+
+    return 0;
+}//end initPmodCapture()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        setPmodTrigger();
+		
+        pmodCapture* cap            Capture to configure
+        byte type                   PMOD_TRIGGER_*
+        uint8_t mask                Pins the trigger looks at
+        uint8_t pattern             Pin values for PMOD_TRIGGER_PATTERN
+
+            Chooses what starts the capture
+        
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void setPmodTrigger(pmodCapture* cap, byte type, uint8_t mask, uint8_t pattern) {
+
+    cap->trigger = type;
+    cap->mask = mask;
+    cap->pattern = pattern & mask;
+
+    return;
+}//end setPmodTrigger()
+
+// Appends a run to the capture ring, overwriting the oldest when full
+static inline void pmodCaptureRun(pmodCapture* cap, uint32_t sample, uint8_t pins) {
+
+    cap->runs[cap->head].sample = sample;
+    cap->runs[cap->head].pins = pins;
+
+    cap->head = (cap->head + 1 == cap->capacity) ? 0 : cap->head + 1;
+    if(cap->count < cap->capacity) {
+        cap->count++;
+    }
+
+    return;
+}
+
+// Whether the pins going from 'prev' to 'pins' fires the trigger of 'cap'
+static inline bool pmodTriggered(const pmodCapture* cap, uint8_t prev, uint8_t pins) {
+
+    switch(cap->trigger) {
+        case PMOD_TRIGGER_RISING:   return (~prev & pins & cap->mask) != 0;
+        case PMOD_TRIGGER_FALLING:  return (prev & ~pins & cap->mask) != 0;
+        case PMOD_TRIGGER_EDGE:     return ((prev ^ pins) & cap->mask) != 0;
+        case PMOD_TRIGGER_PATTERN:  return (pins & cap->mask) == cap->pattern;
+        default:                    return true;
+    }
+}
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        runPmodCapture();
+		
+        pmodCapture* cap            Capture to run
+        uint32_t samples            Samples to take after the trigger
+        uint32_t timeout            Samples to wait for the trigger, 0 to wait forever
+
+            Logic analyzer for both PMOD B rows. Samples DATA_2_RO in a
+            tight loop. DATA_2_RO shows pin levels whatever the direction,
+            so pins keep their setup and outputs (the library's own SPI
+            and UART lines too) are captured as well. Only pin changes are
+            stored (run-length encoded), so memory depends on activity
+            rather than length. Timestamps are sample numbers, turned into time
+            from the measured sample rate, so the loop never reads a clock.
+            History before the trigger is kept as long as the ring has
+            room, the oldest runs are overwritten first. A late trigger
+            shortens a huge 'samples' so the total still fits in 32 bits.
+
+            Returns 0 once captured, -1 if the trigger never fired.
+        
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+int runPmodCapture(pmodCapture* cap, uint32_t samples, uint32_t timeout) {
+
+    volatile unsigned int* const reg = klibReg(DATA_2_RO);
+    unsigned long long start;
+    uint32_t s = 0;
+    uint32_t stop;
+    uint8_t prev, pins;
+
+    cap->head = 0;
+    cap->count = 0;
+
+    start = getNanos();
+
+    // the first sample always opens a run, and may already match a pattern
+    prev = (*reg >> 7) & 0xFF;
+    pmodCaptureRun(cap, 0, prev);
+
+    if(cap->trigger != PMOD_TRIGGER_NONE &&
+       !(cap->trigger == PMOD_TRIGGER_PATTERN && pmodTriggered(cap, prev, prev))) {
+        for(;;) {
+            pins = (*reg >> 7) & 0xFF;
+            s++;
+            if(pins != prev) {
+                pmodCaptureRun(cap, s, pins);
+                if(pmodTriggered(cap, prev, pins)) {
+                    prev = pins;
+                    break;
+                }
+                prev = pins;
+            }
+            if(timeout != 0 && s >= timeout) {
+                cap->ns = getNanos() - start;
+                cap->samples = s + 1;
+                mmioBurstRead(DATA_2_RO, cap->samples);
+                return -1;
+            }
+        }
+    }
+
+    cap->trigger_sample = s;
+
+    // s + samples + 1 must not wrap, or the loop below would end at once
+    if(samples > UINT32_MAX - 1 - s) {
+        samples = UINT32_MAX - 1 - s;
+    }
+    stop = s + samples;
+
+    while(s < stop) {
+        pins = (*reg >> 7) & 0xFF;
+        s++;
+        if(pins != prev) {
+            pmodCaptureRun(cap, s, pins);
+            prev = pins;
+        }
+    }
+
+    cap->ns = getNanos() - start;
+    cap->samples = s + 1;
+    mmioBurstRead(DATA_2_RO, cap->samples);
+
+    return 0;
+}//end runPmodCapture()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        savePmodVCD();
+		
+        const pmodCapture* cap      Capture to export
+        const char* path            File to write
+
+            Writes the capture as a VCD file for waveform viewers (GTKWave,
+            PulseView, ...), one wire per pin plus a 'trigger' wire.
+            Returns 0 on success, -1 if the file could not be written.
+        
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+int savePmodVCD(const pmodCapture* cap, const char* path) {
+
+    // one printable identifier per wire, pins 0-7 then the trigger
+    static const char id[9] = {'!', '"', '#', '$', '%', '&', '\'', '(', ')'};
+    const unsigned int first = (cap->head + cap->capacity - cap->count) % cap->capacity;
+    unsigned long long t;
+    uint8_t prev = 0;
+    uint8_t pins;
+    unsigned int r, idx;
+    bool trig = false;
+    FILE* f;
+    int c;
+
+    if(cap->count == 0 || (f = fopen(path, "w")) == NULL) {
+        return -1;
+    }
+
+    fprintf(f, "$comment PMOD B capture, %u samples in %llu ns $end\n", (unsigned int)cap->samples, cap->ns);
+    fprintf(f, "$timescale 1 ns $end\n$scope module pmodb $end\n");
+    for(c = 0; c < 8; c++) {
+        fprintf(f, "$var wire 1 %c %s%d $end\n", id[c], (c < 4) ? "top" : "bottom", c & 3);
+    }
+    fprintf(f, "$var wire 1 %c trigger $end\n$upscope $end\n$enddefinitions $end\n", id[8]);
+
+    for(r = 0; r < cap->count; r++) {
+        idx = (first + r) % cap->capacity;
+        pins = cap->runs[idx].pins;
+
+        // sample number to time, from the sample rate measured during the capture
+        t = (cap->samples > 1) ? cap->runs[idx].sample * cap->ns / (cap->samples - 1) : 0;
+        fprintf(f, "#%llu\n", t);
+
+        for(c = 0; c < 8; c++) {
+            if(r == 0 || ((prev ^ pins) >> c & 1)) {
+                fprintf(f, "%d%c\n", (pins >> c) & 1, id[c]);
+            }
+        }
+        if(r == 0 || (!trig && cap->runs[idx].sample >= cap->trigger_sample)) {
+            trig = cap->runs[idx].sample >= cap->trigger_sample;
+            fprintf(f, "%d%c\n", trig, id[8]);
+        }
+        prev = pins;
+    }
+
+    fprintf(f, "#%llu\n", cap->ns); // end of capture, so the last run has a length
+
+    return (fclose(f) == 0) ? 0 : -1;
+}//end savePmodVCD()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        freePmodCapture();
+		
+        pmodCapture* cap            Capture to release
+
+            Frees the ring allocated by initPmodCapture()
+        
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void freePmodCapture(pmodCapture* cap) {
+
+    free(cap->runs);
+    cap->runs = NULL;
+    cap->capacity = 0;
+    cap->count = 0;
+
+    return;
+}//end freePmodCapture()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        setupPmodPins();
+		
+        uint8_t pins                PMOD B pins to configure, one bit per pin
+        uint8_t outputs             Which of them become outputs, the rest become inputs
+
+            Per-pin version of setupPmod(), for protocols that mix inputs
+            and outputs on one row. Pins are numbered with PMODB_PIN().
+        
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void setupPmodPins(uint8_t pins, uint8_t outputs) {
+
+    const unsigned int mask = (unsigned int)pins << 7;
+    const unsigned int out = (unsigned int)(outputs & pins) << 7;
+    unsigned int dir, row_bits;
+    int row;
+
+    periphLock(KLIB_PERIPH_PMOD);
+
+    dir = (shadowRead(DIR_2) & ~mask) | out;
+    shadowWrite(DIR_2, dir);
+    shadowWrite(OE_2, (shadowRead(OE_2) & ~mask) | out);
+
+    // keep the row cache of pmodRead()/pmodWrite() honest, a mixed row is 2
+    for(row = 0; row < 2; row++) {
+        row_bits = (dir >> (7 + 4 * row)) & 0xF;
+        klib_pmod_dir[row] = (row_bits == 0xF) ? 1 : (row_bits == 0) ? 0 : 2;
+    }
+    simPmodUpdate();
+
+    periphUnlock(KLIB_PERIPH_PMOD);
+
+    return;
+}//end setupPmodPins()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        simPmodConnect();
+		
+        uint8_t from                PMOD B pin driving the wire, 0xFF to cut the wire
+        uint8_t to                  PMOD B pin reading it
+
+            Simulated backend only. Wires two PMOD B pins together so
+            protocol engines can be tested in loopback on a host: while
+            'to' is an input, DATA_2_RO shows the level of 'from'. Once any
+            wire exists, undriven pins read high as if pulled up.
+        
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void simPmodConnect(uint8_t from, uint8_t to) {
+
+    int p;
+
+    if(to > 7 || (from > 7 && from != 0xFF)) {
+        return;
+    }
+
+    klib_sim_wire[to] = from;
+
+    klib_sim_wired = klib_sim_i2c.scl != 0xFF;
+    for(p = 0; p < 8; p++) {
+        if(klib_sim_wire[p] != 0xFF) {
+            klib_sim_wired = true;
+        }
+    }
+    simPmodUpdate();
+
+    return;
+}//end simPmodConnect()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        simPmodI2cSlave();
+		
+        uint8_t scl, sda            PMOD B pins (PMODB_PIN()) of the bus, 0xFF to remove the slave
+        uint8_t addr                7-bit address the slave answers to
+
+            Simulated backend only. Puts an I2C slave on two PMOD B pins
+            so pmodI2cWrite() and pmodI2cRead() can be tested on a host.
+            It acknowledges its address and every byte written to it,
+            and leaves every other address unacknowledged. It has no
+            data of its own, so reads return 0xFF. Undriven pins read
+            high from then on, as with simPmodConnect().
+        
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void simPmodI2cSlave(uint8_t scl, uint8_t sda, uint8_t addr) {
+
+    int p;
+
+    if(scl > 7 || sda > 7) {
+        scl = 0xFF;
+        sda = 0xFF;
+    }
+
+    memset(&klib_sim_i2c, 0, sizeof(klib_sim_i2c));
+    klib_sim_i2c.scl = scl;
+    klib_sim_i2c.sda = sda;
+    klib_sim_i2c.addr = addr & 0x7F;
+    klib_sim_i2c.scl_prev = true; // released lines read high
+    klib_sim_i2c.sda_prev = true;
+    klib_sim_i2c.bit = -1;
+
+    klib_sim_wired = scl != 0xFF;
+    for(p = 0; p < 8; p++) {
+        if(klib_sim_wire[p] != 0xFF) {
+            klib_sim_wired = true;
+        }
+    }
+    simPmodUpdate();
+
+    return;
+}//end simPmodI2cSlave()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        simPmodI2cReceived();
+		
+        uint8_t* data               Filled with the bytes written to the slave
+        size_t max                  Room in 'data'
+
+            Simulated backend only. Copies the data bytes the slave of
+            simPmodI2cSlave() acknowledged since it was set up, the
+            first 16 at most. Returns how many were copied.
+        
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+size_t simPmodI2cReceived(uint8_t* data, size_t max) {
+
+    const size_t n = (klib_sim_i2c.count < max) ? klib_sim_i2c.count : max;
+
+    memcpy(data, klib_sim_i2c.rx, n);
+
+    return n;
+}//end simPmodI2cReceived()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        initPmodSpi();
+		
+        pmodSpi* spi                SPI master to set up
+        uint8_t sck, mosi, miso, cs PMOD B pins (PMODB_PIN()), cs 0xFF for none
+        byte mode                   SPI mode 0-3
+        unsigned long hz            Clock rate, 0 for as fast as the bus allows
+
+            Software SPI master on PMOD B. Every register word the clock
+            and data pins can need is built here, so a bit costs two
+            table-driven stores and one load. Edges are placed on absolute
+            deadlines, so the clock rate doesn't drift with bus latency.
+        
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void initPmodSpi(pmodSpi* spi, uint8_t sck, uint8_t mosi, uint8_t miso, uint8_t cs, byte mode, unsigned long hz) {
+
+    const unsigned int sck_bit = PMODB_BIT(sck);
+    const unsigned int mosi_bit = PMODB_BIT(mosi);
+    const unsigned int cs_bit = (cs == 0xFF) ? 0 : PMODB_BIT(cs);
+    const unsigned int keep = (~(sck_bit | mosi_bit) & 0xFFFF) << 16;
+    int m, k;
+
+    periphLock(KLIB_PERIPH_PMOD);
+
+    spi->miso_bit = PMODB_BIT(miso);
+    spi->mode = mode & 3;
+    spi->half_ns = hz ? (unsigned int)(500000000UL / hz) : 0;
+
+    for(m = 0; m < 2; m++) {
+        for(k = 0; k < 2; k++) {
+            spi->word[m][k] = keep | (m ? mosi_bit : 0) | (k ? sck_bit : 0);
+        }
+    }
+    // with no chip select both words leave every pin alone
+    spi->cs_word[0] = (~cs_bit & 0xFFFF) << 16;
+    spi->cs_word[1] = ((~cs_bit & 0xFFFF) << 16) | cs_bit;
+
+    setupPmodPins((uint8_t)((sck_bit | mosi_bit | spi->miso_bit | cs_bit) >> 7), (uint8_t)((sck_bit | mosi_bit | cs_bit) >> 7));
+
+    // idle: deselected, clock at CPOL
+    pmodStore(spi->cs_word[1]);
+    pmodStore(spi->word[1][spi->mode >> 1]);
+
+    periphUnlock(KLIB_PERIPH_PMOD);
+
+    return;
+}//end initPmodSpi()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        pmodSpiTransfer();
+		
+        pmodSpi* spi                SPI master to use
+        const uint8_t* tx           Bytes to send, NULL to send 0xFF
+        uint8_t* rx                 Filled with the bytes received, may be NULL
+        size_t n                    Number of bytes
+
+            Full-duplex transfer, MSB first, with chip select held low throughout
+        
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void pmodSpiTransfer(pmodSpi* spi, const uint8_t* tx, uint8_t* rx, size_t n) {
+
+    const int idle = spi->mode >> 1;
+    const bool cpha = spi->mode & 1;
+    unsigned long long t;
+    unsigned int out, in, bit = 1;
+    size_t i;
+    int b;
+
+    pmodStore(spi->cs_word[0]);
+    t = getNanos() + spi->half_ns;
+    spinUntilNs(t);
+
+    for(i = 0; i < n; i++) {
+        out = tx ? tx[i] : 0xFF;
+        in = 0;
+
+        for(b = 7; b >= 0; b--) {
+            bit = (out >> b) & 1;
+
+            if(!cpha) {
+                // data changes with the clock at idle, sampled on the leading edge
+                pmodStore(spi->word[bit][idle]);
+                t += spi->half_ns;
+                spinUntilNs(t);
+                pmodStore(spi->word[bit][!idle]);
+                in = (in << 1) | ((mmioRead(DATA_2_RO) & spi->miso_bit) != 0);
+            } else {
+                // data changes on the leading edge, sampled on the trailing edge
+                pmodStore(spi->word[bit][!idle]);
+                t += spi->half_ns;
+                spinUntilNs(t);
+                pmodStore(spi->word[bit][idle]);
+                in = (in << 1) | ((mmioRead(DATA_2_RO) & spi->miso_bit) != 0);
+            }
+            t += spi->half_ns;
+            spinUntilNs(t);
+        }
+
+        if(rx != NULL) {
+            rx[i] = (uint8_t)in;
+        }
+    }
+
+    pmodStore(spi->word[bit][idle]);
+    t += spi->half_ns;
+    spinUntilNs(t);
+    pmodStore(spi->cs_word[1]);
+
+    return;
+}//end pmodSpiTransfer()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        initPmodI2c();
+		
+        pmodI2c* i2c                I2C master to set up
+        uint8_t scl, sda            PMOD B pins (PMODB_PIN()), need external pull-ups
+        unsigned long hz            Clock rate
+
+            Software I2C master on PMOD B. Lines are open-drain: a low is
+            an output driving 0, a high is an input left to the pull-up,
+            so each edge is one DIR_2 store. The word is built from the
+            DIR_2 shadow, so other PMOD B pins keep whatever direction
+            they were given since. Clock stretching by the slave is honored.
+        
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+#define I2C_STRETCH_NS 25000000ULL // longest clock stretch honored (SMBus timeout)
+
+void initPmodI2c(pmodI2c* i2c, uint8_t scl, uint8_t sda, unsigned long hz) {
+
+    const unsigned int scl_bit = PMODB_BIT(scl);
+    const unsigned int sda_bit = PMODB_BIT(sda);
+
+    periphLock(KLIB_PERIPH_PMOD);
+
+    i2c->scl_bit = scl_bit;
+    i2c->sda_bit = sda_bit;
+    i2c->quarter_ns = hz ? (unsigned int)(250000000UL / hz) : 0;
+
+    // both lines released: inputs left to the pull-ups, output latch and driver ready at 0
+    setupPmodPins((uint8_t)((scl_bit | sda_bit) >> 7), 0);
+    pmodMaskedWrite(scl_bit | sda_bit, 0);
+    shadowWrite(OE_2, shadowRead(OE_2) | scl_bit | sda_bit);
+
+    // these rows now change direction behind the row cache
+    klib_pmod_dir[(scl_bit & PMODB_BOTTOM_MASK) != 0] = 2;
+    klib_pmod_dir[(sda_bit & PMODB_BOTTOM_MASK) != 0] = 2;
+
+    i2c->scl_low = false;
+    i2c->sda_low = false;
+    pmodDirStore(shadowRead(DIR_2) & ~(scl_bit | sda_bit));
+
+    periphUnlock(KLIB_PERIPH_PMOD);
+
+    return;
+}//end initPmodI2c()
+
+// Pulls the I2C lines low or releases them, then waits 'quarters' quarter periods (PMOD lock held)
+static void i2cLines(pmodI2c* i2c, bool scl_low, bool sda_low, int quarters) {
+
+    const bool releasing = i2c->scl_low && !scl_low;
+    unsigned long long start;
+
+    i2c->scl_low = scl_low;
+    i2c->sda_low = sda_low;
+
+    // only the two lines change, the rest of DIR_2 comes from the shadow (no bus read)
+    pmodDirStore((shadowRead(DIR_2) & ~(i2c->scl_bit | i2c->sda_bit)) |
+                 (scl_low ? i2c->scl_bit : 0) | (sda_low ? i2c->sda_bit : 0));
+
+    // a slave may hold SCL low to stretch the clock, timing restarts once it lets go
+    if(releasing && !(mmioRead(DATA_2_RO) & i2c->scl_bit)) {
+        start = getNanos();
+        while(!(mmioRead(DATA_2_RO) & i2c->scl_bit) && getNanos() - start < I2C_STRETCH_NS) {
+        }
+        i2c->t = getNanos();
+    }
+
+    i2c->t += (unsigned long long)i2c->quarter_ns * quarters;
+    spinUntilNs(i2c->t);
+
+    return;
+}
+
+// Clocks one bit out (SCL low on entry and exit)
+static void i2cWriteBit(pmodI2c* i2c, bool bit) {
+
+    i2cLines(i2c, true, !bit, 1);
+    i2cLines(i2c, false, !bit, 2);
+    i2cLines(i2c, true, !bit, 1);
+
+    return;
+}
+
+// Clocks one bit in with SDA released (SCL low on entry and exit)
+static bool i2cReadBit(pmodI2c* i2c) {
+
+    bool bit;
+
+    i2cLines(i2c, true, false, 1);
+    i2cLines(i2c, false, false, 1);
+    bit = (mmioRead(DATA_2_RO) & i2c->sda_bit) != 0;
+    i2cLines(i2c, false, false, 1);
+    i2cLines(i2c, true, false, 1);
+
+    return bit;
+}
+
+// Sends a byte MSB first, returns true if the slave acknowledged it
+static bool i2cWriteByte(pmodI2c* i2c, uint8_t data) {
+
+    int b;
+
+    for(b = 7; b >= 0; b--) {
+        i2cWriteBit(i2c, (data >> b) & 1);
+    }
+
+    return !i2cReadBit(i2c);
+}
+
+// START then the address byte, returns true if the slave acknowledged it
+static bool i2cStart(pmodI2c* i2c, uint8_t addr, bool read) {
+
+    i2c->t = getNanos();
+    i2cLines(i2c, false, false, 2);
+    i2cLines(i2c, false, true, 2);  // SDA falls while SCL is high
+    i2cLines(i2c, true, true, 1);
+
+    return i2cWriteByte(i2c, (uint8_t)((addr << 1) | read));
+}
+
+// STOP, leaves both lines released
+static void i2cStop(pmodI2c* i2c) {
+
+    i2cLines(i2c, true, true, 1);
+    i2cLines(i2c, false, true, 2);
+    i2cLines(i2c, false, false, 2); // SDA rises while SCL is high
+
+    return;
+}
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        pmodI2cWrite();
+		
+        pmodI2c* i2c                I2C master to use
+        uint8_t addr                7-bit slave address
+        const uint8_t* data         Bytes to write
+        size_t n                    Number of bytes
+
+            Returns 0 if every byte was acknowledged, -1 on a NACK
+        
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+int pmodI2cWrite(pmodI2c* i2c, uint8_t addr, const uint8_t* data, size_t n) {
+
+    size_t i;
+
+    periphLock(KLIB_PERIPH_PMOD);
+
+    if(!i2cStart(i2c, addr, 0)) {
+        i2cStop(i2c);
+        periphUnlock(KLIB_PERIPH_PMOD);
+        return -1;
+    }
+
+    for(i = 0; i < n; i++) {
+        if(!i2cWriteByte(i2c, data[i])) {
+            i2cStop(i2c);
+            periphUnlock(KLIB_PERIPH_PMOD);
+            return -1;
+        }
+    }
+
+    i2cStop(i2c);
+
+    periphUnlock(KLIB_PERIPH_PMOD);
+
+    return 0;
+}//end pmodI2cWrite()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        pmodI2cRead();
+		
+        pmodI2c* i2c                I2C master to use
+        uint8_t addr                7-bit slave address
+        uint8_t* data               Filled with the bytes read
+        size_t n                    Number of bytes
+
+            Returns 0 on success, -1 if the address was not acknowledged
+        
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+int pmodI2cRead(pmodI2c* i2c, uint8_t addr, uint8_t* data, size_t n) {
+
+    unsigned int in;
+    size_t i;
+    int b;
+
+    periphLock(KLIB_PERIPH_PMOD);
+
+    if(!i2cStart(i2c, addr, 1)) {
+        i2cStop(i2c);
+        periphUnlock(KLIB_PERIPH_PMOD);
+        return -1;
+    }
+
+    for(i = 0; i < n; i++) {
+        in = 0;
+        for(b = 0; b < 8; b++) {
+            in = (in << 1) | i2cReadBit(i2c);
+        }
+        data[i] = (uint8_t)in;
+        i2cWriteBit(i2c, i + 1 == n); // ACK every byte but the last
+    }
+
+    i2cStop(i2c);
+
+    periphUnlock(KLIB_PERIPH_PMOD);
+
+    return 0;
+}//end pmodI2cRead()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        initPmodUart();
+		
+        pmodUart* uart              UART to set up
+        uint8_t tx, rx              PMOD B pins (PMODB_PIN())
+        unsigned long baud          Bit rate
+
+            Software 8N1 UART on PMOD B. TX idles high. Bits are placed on
+            absolute deadlines from the start bit, so timing errors don't
+            add up across a frame.
+        
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void initPmodUart(pmodUart* uart, uint8_t tx, uint8_t rx, unsigned long baud) {
+
+    const unsigned int tx_bit = PMODB_BIT(tx);
+
+    periphLock(KLIB_PERIPH_PMOD);
+
+    uart->bit_ns = baud ? (unsigned int)(1000000000UL / baud) : 0;
+    uart->word[0] = (~tx_bit & 0xFFFF) << 16;
+    uart->word[1] = ((~tx_bit & 0xFFFF) << 16) | tx_bit;
+    uart->rx_bit = PMODB_BIT(rx);
+
+    setupPmodPins((uint8_t)((tx_bit | uart->rx_bit) >> 7), (uint8_t)(tx_bit >> 7));
+    pmodStore(uart->word[1]); // idle high
+
+    periphUnlock(KLIB_PERIPH_PMOD);
+
+    return;
+}//end initPmodUart()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        pmodUartWrite();
+		
+        pmodUart* uart              UART to use
+        const uint8_t* data         Bytes to send
+        size_t n                    Number of bytes
+
+            Sends bytes, blocking until the last stop bit is out
+        
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void pmodUartWrite(pmodUart* uart, const uint8_t* data, size_t n) {
+
+    unsigned long long t;
+    size_t i;
+    int b;
+
+    for(i = 0; i < n; i++) {
+        t = getNanos();
+        pmodStore(uart->word[0]); // start bit
+
+        for(b = 0; b < 8; b++) {
+            t += uart->bit_ns;
+            spinUntilNs(t);
+            pmodStore(uart->word[(data[i] >> b) & 1]);
+        }
+
+        t += uart->bit_ns;
+        spinUntilNs(t);
+        pmodStore(uart->word[1]); // stop bit
+        t += uart->bit_ns;
+        spinUntilNs(t);
+    }
+
+    return;
+}//end pmodUartWrite()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        pmodUartRead();
+		
+        pmodUart* uart              UART to use
+        uint8_t* data               Filled with the bytes received
+        size_t n                    Number of bytes wanted
+        unsigned int timeout_ms     Longest wait for each start bit
+
+            Receives bytes, sampling each bit in its middle.
+            Returns the number of bytes received before a timeout.
+        
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+size_t pmodUartRead(pmodUart* uart, uint8_t* data, size_t n, unsigned int timeout_ms) {
+
+    const unsigned long long timeout_ns = (unsigned long long)timeout_ms * 1000000ULL;
+    unsigned long long start, t;
+    unsigned int in;
+    size_t i = 0;
+    int b;
+
+    while(i < n) {
+        // wait for the falling edge of a start bit
+        start = getNanos();
+        while(mmioRead(DATA_2_RO) & uart->rx_bit) {
+            if(getNanos() - start > timeout_ns) {
+                return i;
+            }
+        }
+
+        // middle of the start bit, a glitch is back high by then
+        t = getNanos() + uart->bit_ns / 2;
+        spinUntilNs(t);
+        if(mmioRead(DATA_2_RO) & uart->rx_bit) {
+            continue;
+        }
+
+        in = 0;
+        for(b = 0; b < 8; b++) {
+            t += uart->bit_ns;
+            spinUntilNs(t);
+            in |= ((mmioRead(DATA_2_RO) & uart->rx_bit) != 0) << b;
+        }
+        data[i++] = (uint8_t)in;
+
+        // middle of the stop bit, so the next start edge isn't taken from a data bit
+        t += uart->bit_ns;
+        spinUntilNs(t);
+    }
+
+    return i;
+}//end pmodUartRead()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        initMarquee();
+		
+        sevSegMarquee* m        Marquee to set up
+        const char* str         Text of any length
+        unsigned long step_ms   Time each 4-character window stays up
+        byte mode               SEVSEG_MARQUEE_LOOP, _PINGPONG or _ONESHOT
+
+            Encodes 'str' once into glyph codes, so stepping only shifts
+            the 32-bit frame by one digit.
+
+            Returns 0 on success, -1 if memory ran out.
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+int initMarquee(sevSegMarquee* m, const char* str, unsigned long step_ms, byte mode) {
+
+    const unsigned int len = strlen(str);
+    unsigned int length = len;
+    unsigned int c;
+
+    if(mode == SEVSEG_MARQUEE_LOOP) {
+        length++; // blank between the end of the text and the next repeat
+    }
+    if(length < 4) {
+        length = 4; // always enough glyphs to fill the display
+    }
+
+    m->glyphs = malloc(length);
+    if(m->glyphs == NULL) {
+        return -1;
+    }
+
+    // glyph table entries are inverted, padding is blank with decimal point off
+    for(c = 0; c < length; c++) {
+        m->glyphs[c] = (c < len) ? (unsigned char)~sevseg_glyph[(unsigned char)str[c]] : 0xFF;
+    }
+
+    m->length = length;
+    m->step_ms = step_ms;
+    m->mode = mode;
+    resetMarquee(m);
+
+    return 0;
+}//end initMarquee()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        resetMarquee();
+		
+        sevSegMarquee* m        Marquee to rewind
+
+            Goes back to the start of the text, the next tickMarquee() shows it
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void resetMarquee(sevSegMarquee* m) {
+
+    m->pos = 0;
+    m->frame = ((unsigned int)m->glyphs[0] << 24) | ((unsigned int)m->glyphs[1] << 16) |
+               ((unsigned int)m->glyphs[2] << 8) | m->glyphs[3];
+    m->started = false;
+    m->reverse = false;
+    m->done = false;
+
+    return;
+}//end resetMarquee()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        tickMarquee();
+		
+        sevSegMarquee* m        Marquee to advance
+        unsigned long now       Current time from getMillis()
+
+            Non-blocking. Shows the first window on the first call, then
+            advances one digit each time 'step_ms' has passed. Only the
+            incoming glyph is touched, the rest of the frame is shifted.
+
+            Returns 1 if the display changed, 0 otherwise.
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+bool tickMarquee(sevSegMarquee* m, unsigned long now) {
+
+    unsigned int in; // index of the glyph shifting in
+
+    if(!m->started) {
+        m->started = true;
+        m->next_ms = now + m->step_ms;
+        outputToSevSegFrame(m->frame);
+        return true;
+    }
+
+    if(m->done || (long)(now - m->next_ms) < 0) {
+        return false;
+    }
+
+    // keep a steady cadence, but don't try to catch up after a long stall
+    m->next_ms += m->step_ms;
+    if((long)(now - m->next_ms) >= 0) {
+        m->next_ms = now + m->step_ms;
+    }
+
+    switch(m->mode) {
+        default:
+        case SEVSEG_MARQUEE_LOOP:
+            m->pos = (m->pos + 1 == m->length) ? 0 : m->pos + 1;
+            in = m->pos + 3;
+            if(in >= m->length) {
+                in -= m->length;
+            }
+            m->frame = (m->frame << 8) | m->glyphs[in];
+            break;
+
+        case SEVSEG_MARQUEE_PINGPONG:
+            if(m->length == 4) {
+                return false; // nothing to scroll
+            }
+            if(!m->reverse) {
+                m->pos++;
+                m->frame = (m->frame << 8) | m->glyphs[m->pos + 3];
+                m->reverse = (m->pos + 4 == m->length);
+            } else {
+                m->pos--;
+                m->frame = (m->frame >> 8) | ((unsigned int)m->glyphs[m->pos] << 24);
+                m->reverse = (m->pos != 0);
+            }
+            break;
+
+        case SEVSEG_MARQUEE_ONESHOT:
+            if(m->pos + 4 >= m->length) {
+                m->done = true;
+                return false;
+            }
+            m->pos++;
+            m->frame = (m->frame << 8) | m->glyphs[m->pos + 3];
+            m->done = (m->pos + 4 == m->length);
+            break;
+    }
+
+    outputToSevSegFrame(m->frame);
+
+    return true;
+}//end tickMarquee()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        freeMarquee();
+		
+        sevSegMarquee* m        Marquee to release
+
+            Frees the glyph codes allocated by initMarquee()
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void freeMarquee(sevSegMarquee* m) {
+
+    free(m->glyphs);
+    m->glyphs = NULL;
+    m->length = 0;
+
+    return;
+}//end freeMarquee()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        readBoardFrame();
+		
+        boardFrame* f           Frame to fill
+
+            Fills a frame with what the board currently shows (taken from
+            the shadow registers), a starting point for the next draw
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void readBoardFrame(boardFrame* f) {
+
+    int c;
+
+    lockBoard();
+
+    f->led = shadowRead(LED_ADDR);
+    f->sevseg_ctrl = shadowRead(SEVSEG_CTRL_ADDR);
+    f->sevseg_data = shadowRead(SEVSEG_DATA_ADDR);
+
+    for(c = 0; c < 6; c++) {
+        f->rgb_en[c] = shadowRead(RGB_EN_BASEADDR + c * 0x10);
+        f->rgb_period[c] = shadowRead(RGB_PERIOD_BASEADDR + c * 0x10);
+        f->rgb_width[c] = shadowRead(RGB_WIDTH_BASEADDR + c * 0x10);
+    }
+
+    unlockBoard();
+
+    return;
+}//end readBoardFrame()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        frameLEDs();
+		
+        boardFrame* f           Frame to draw into
+        int val                 Value to push to the LEDs
+
+            Same as outputToLEDs(), but only changes the frame
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void frameLEDs(boardFrame* f, int val) {
+
+    f->led = val & 0b1111111111;
+
+    return;
+}//end frameLEDs()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        frameSevSeg();
+		
+        boardFrame* f           Frame to draw into
+        int val                 Value to push to the seven-segment display
+        byte mode               Display mode. 0-hexadecimal, 1-decimal, 2-binary
+
+            Same as outputToSevSeg(), but only changes the frame
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void frameSevSeg(boardFrame* f, int val, byte mode) {
+
+    f->sevseg_data = sevSegValueFrame(val, mode, &f->sevseg_ctrl);
+
+    return;
+}//end frameSevSeg()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        frameSevSegCustom();
+		
+        boardFrame* f           Frame to draw into
+        const char* str         Input string, only first 4 characters are used
+
+            Same as outputToSevSegCustom(), but only changes the frame
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void frameSevSegCustom(boardFrame* f, const char* str) {
+
+    f->sevseg_ctrl = 0b11;
+    f->sevseg_data = encodeSevSeg(str);
+
+    return;
+}//end frameSevSegCustom()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        frameEnableRGB();
+		
+        boardFrame* f           Frame to draw into
+        unsigned int select     Binary number to enable each LED
+
+            Same as enableRGB(), but only changes the frame
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void frameEnableRGB(boardFrame* f, unsigned int select) {
+
+    int c;
+
+    for(c = 0; c < 3; c++) {
+        f->rgb_en[c] = bitIndex(select, 0);
+        f->rgb_en[c + 3] = bitIndex(select, 1);
+    }
+
+    return;
+}//end frameEnableRGB()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        frameRGB();
+		
+        boardFrame* f               Frame to draw into
+        unsigned int select         Picks which LED to send to
+        unsigned int color          HEX color to display (0xNNNNNN)
+        float bright                0.0 - 1.0 value to determine brightness of LED
+
+            Same as outputToRGB(), but only changes the frame. Any
+            nonzero 'select' picks the second LED.
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void frameRGB(boardFrame* f, unsigned int select, unsigned int color, float bright) {
+
+    const unsigned int offset = (select != 0) * 3; // first channel of the selected LED, never past rgb_width[5]
+    const unsigned int gain = rgbBrightGamma(rgbBrightFixed(bright));
+    int c;
+
+    for(c = 0; c < 3; c++) {
+        f->rgb_period[offset + c] = 2550;
+        f->rgb_width[offset + c] = rgbWidth(color, c, gain);
+    }
+
+    return;
+}//end frameRGB()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        commitBoardFrame();
+		
+        const boardFrame* f     Frame to show
+
+            Shows a whole frame at once. Only registers whose value differs
+            from what the board shows are written, always in the same order:
+            RGB periods, widths and enables, seven-segment ctrl and data,
+            then LEDs. A full UI refresh becomes one short burst of stores
+            instead of several separate output calls.
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void commitBoardFrame(const boardFrame* f) {
+
+    int c;
+
+    lockBoard();
+
+    // periods before widths, so a width never exceeds its new period
+    for(c = 0; c < 6; c++) {
+        shadowWrite(RGB_PERIOD_BASEADDR + c * 0x10, f->rgb_period[c]);
+    }
+    for(c = 0; c < 6; c++) {
+        shadowWrite(RGB_WIDTH_BASEADDR + c * 0x10, f->rgb_width[c]);
+    }
+    for(c = 0; c < 6; c++) {
+        shadowWrite(RGB_EN_BASEADDR + c * 0x10, f->rgb_en[c]);
+    }
+
+    shadowWrite(SEVSEG_CTRL_ADDR, f->sevseg_ctrl);
+    shadowWrite(SEVSEG_DATA_ADDR, f->sevseg_data);
+
+    shadowWrite(LED_ADDR, f->led);
+
+    unlockBoard();
+
+    return;
+}//end commitBoardFrame()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        initInputEngine();
+		
+        inputEngine* e          Engine to set up
+        unsigned int sample_us  Time between samples when run by startInputSampler()
+        unsigned int hold_ms    Time a button is held until INPUT_EVENT_HOLD, 0 for none
+        unsigned int repeat_ms  Time between INPUT_EVENT_REPEATs after the hold, 0 for none
+
+            Debounces all 16 inputs (4 buttons, 12 switches) in parallel.
+            Each input needs 4 identical samples in a row to change state,
+            kept in a 2-bit vertical counter spread over two words, so one
+            sample costs a handful of bitwise operations for every input.
+            Only the buttons (INPUT_HOLD_MASK) send INPUT_EVENT_HOLD and
+            INPUT_EVENT_REPEAT; a switch left on stays quiet after its
+            press, so it can't fill the queue and crowd out button events.
+
+            Run sampleInputs() at a fixed rate yourself, or let
+            startInputSampler() do it on its own thread, and drain the
+            events with nextInputEvent().
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void initInputEngine(inputEngine* e, unsigned int sample_us, unsigned int hold_ms, unsigned int repeat_ms) {
+
+    int c;
+
+    if(sample_us == 0) {
+        sample_us = 1000;
+    }
+
+    e->state = 0;
+    e->cnt0 = 0;
+    e->cnt1 = 0;
+    e->sample_us = sample_us;
+    e->hold_ticks = (unsigned long)hold_ms * 1000 / sample_us;
+    e->repeat_ticks = (unsigned long)repeat_ms * 1000 / sample_us;
+    e->dropped = 0;
+
+    for(c = 0; c < INPUT_COUNT; c++) {
+        e->held[c] = 0;
+    }
+
+    atomic_init(&e->head, 0);
+    atomic_init(&e->tail, 0);
+    atomic_init(&e->running, false);
+
+    return;
+}//end initInputEngine()
+
+// Producer side of the event ring, drops the event when the application fell behind
+static inline void pushInputEvent(inputEngine* e, int input, byte type, unsigned long now) {
+
+    const unsigned int head = atomic_load_explicit(&e->head, memory_order_relaxed);
+    inputEvent* ev;
+
+    if(head - atomic_load_explicit(&e->tail, memory_order_acquire) == INPUT_QUEUE_SIZE) {
+        e->dropped++;
+        return;
+    }
+
+    ev = &e->queue[head & (INPUT_QUEUE_SIZE - 1)];
+    ev->time = now;
+    ev->input = input;
+    ev->type = type;
+
+    // publish the slot only once it is filled in
+    atomic_store_explicit(&e->head, head + 1, memory_order_release);
+
+    return;
+}
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        sampleInputs();
+		
+        inputEngine* e          Engine to advance
+        unsigned long now       Current time from getMillis()
+
+            Reads the buttons and switches once, debounces them and queues
+            the resulting events. Only ever call it from one thread.
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void sampleInputs(inputEngine* e, unsigned long now) {
+
+    const unsigned int sample = getButtonStates() | (getSwitchStates() << 4);
+    const unsigned int delta = sample ^ e->state;
+    unsigned int toggle;
+    unsigned int bits;
+    int i;
+
+    // 2-bit vertical counter: counts consecutive samples that disagree with
+    // the debounced state and resets on any sample that agrees
+    e->cnt1 = (e->cnt1 ^ e->cnt0) & delta;
+    e->cnt0 = ~e->cnt0 & delta;
+    toggle = delta & ~(e->cnt0 | e->cnt1); // wrapped around, 4 in a row
+    e->state ^= toggle;
+
+    bits = toggle;
+    while(bits) {
+        i = __builtin_ctz(bits);
+        bits &= bits - 1;
+
+        e->held[i] = 0;
+        pushInputEvent(e, i, ((e->state >> i) & 1) ? INPUT_EVENT_PRESS : INPUT_EVENT_RELEASE, now);
+    }
+
+    if(e->hold_ticks == 0) {
+        return;
+    }
+
+    // only buttons that are held need a timer
+    bits = e->state & ~toggle & INPUT_HOLD_MASK;
+    while(bits) {
+        i = __builtin_ctz(bits);
+        bits &= bits - 1;
+
+        e->held[i]++;
+        if(e->held[i] == e->hold_ticks) {
+            pushInputEvent(e, i, INPUT_EVENT_HOLD, now);
+        } else if(e->repeat_ticks != 0 && e->held[i] > e->hold_ticks &&
+                  (e->held[i] - e->hold_ticks) % e->repeat_ticks == 0) {
+            pushInputEvent(e, i, INPUT_EVENT_REPEAT, now);
+        }
+    }
+
+    return;
+}//end sampleInputs()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        nextInputEvent();
+		
+        inputEngine* e          Engine to drain
+        inputEvent* ev          Filled with the oldest event
+
+            Lock-free, safe to call from one thread while another samples.
+            Returns 1 if an event was taken, 0 if the queue is empty.
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+bool nextInputEvent(inputEngine* e, inputEvent* ev) {
+
+    const unsigned int tail = atomic_load_explicit(&e->tail, memory_order_relaxed);
+
+    if(tail == atomic_load_explicit(&e->head, memory_order_acquire)) {
+        return false;
+    }
+
+    *ev = e->queue[tail & (INPUT_QUEUE_SIZE - 1)];
+
+    // hand the slot back to the sampler only after copying it out
+    atomic_store_explicit(&e->tail, tail + 1, memory_order_release);
+
+    return true;
+}//end nextInputEvent()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        getDebouncedInputs();
+		
+        inputEngine* e          Engine to query
+
+            Returns the debounced state of all 16 inputs,
+            buttons in bits 0-3, switches in bits 4-15
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+unsigned int getDebouncedInputs(inputEngine* e) {
+    return e->state;
+}//end getDebouncedInputs()
+
+#ifdef __linux__
+// Sampler thread, wakes on absolute deadlines so the rate doesn't drift
+static void* inputSamplerThread(void* arg) {
+
+    inputEngine* e = arg;
+    struct timespec next;
+
+    clock_gettime(CLOCK_MONOTONIC, &next);
+
+    while(atomic_load_explicit(&e->running, memory_order_relaxed)) {
+        sampleInputs(e, getMillis());
+
+        next.tv_nsec += (long)e->sample_us * 1000;
+        while(next.tv_nsec >= 1000000000L) {
+            next.tv_nsec -= 1000000000L;
+            next.tv_sec++;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+    }
+
+    return NULL;
+}
+#endif
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        startInputSampler();
+		
+        inputEngine* e          Engine to run
+
+            Starts a thread calling sampleInputs() every sample_us.
+            Returns 0 on success, -1 if the thread could not be started.
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+int startInputSampler(inputEngine* e) {
+
+#ifdef __linux__
+    atomic_store(&e->running, true);
+
+    if(pthread_create(&e->thread, NULL, inputSamplerThread, e) != 0) {
+        atomic_store(&e->running, false);
+        return -1;
+    }
+
+    return 0;
+#else
+    (void)e;
+    return -1;
+#endif
+}//end startInputSampler()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        stopInputSampler();
+		
+        inputEngine* e          Engine to stop
+
+            Stops and joins the thread started by startInputSampler()
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void stopInputSampler(inputEngine* e) {
+
+#ifdef __linux__
+    if(atomic_exchange(&e->running, false)) {
+        pthread_join(e->thread, NULL);
+    }
+#else
+    (void)e;
+#endif
+
+    return;
+}//end stopInputSampler()
+
+static int klib_input_event_fd = -1; // fake interrupt source set by setInputEventFd()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        enableInputInterrupts();
+
+            Turns on the channel 1 interrupt of the buttons and switches
+            AXI GPIO blocks and clears anything pending, so any edge on
+            an input raises an interrupt for waitForInput()
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void enableInputInterrupts() {
+
+    // clear whatever is pending (toggle-on-write), then enable channel 1 and the global enable
+    mmioWrite(BUTTONS_ADDR + AXI_GPIO_IP_ISR, mmioRead(BUTTONS_ADDR + AXI_GPIO_IP_ISR));
+    mmioWrite(BUTTONS_ADDR + AXI_GPIO_IP_IER, 0b1);
+    mmioWrite(BUTTONS_ADDR + AXI_GPIO_GIER, 0x80000000);
+
+    mmioWrite(SWITCHES_ADDR + AXI_GPIO_IP_ISR, mmioRead(SWITCHES_ADDR + AXI_GPIO_IP_ISR));
+    mmioWrite(SWITCHES_ADDR + AXI_GPIO_IP_IER, 0b1);
+    mmioWrite(SWITCHES_ADDR + AXI_GPIO_GIER, 0x80000000);
+
+    return;
+}//end enableInputInterrupts()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        setInputEventFd();
+		
+        int fd                  eventfd to wait on, -1 to go back to the UIO devices
+
+            Makes waitForInput() wait on an eventfd instead of the UIO
+            interrupts, so input wake-ups can be faked without hardware.
+            Write the INPUT_SOURCE_* bits of what fired; waitForInput()
+            returns them and acknowledges those blocks as it would after
+            a real interrupt. Writes made before one wake-up add up, so
+            write each source once per wake-up.
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void setInputEventFd(int fd) {
+
+    klib_input_event_fd = fd;
+
+    return;
+}//end setInputEventFd()
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        waitForInput();
+		
+        int timeout_ms          Longest time to sleep, -1 to wait forever
+
+            Sleeps in poll() until a button or switch changes, instead of
+            spinning on getButtonStates(). Needs the UIO backend (the
+            interrupt of each AXI GPIO block arrives on its /dev/uioN)
+            or a descriptor given to setInputEventFd().
+
+            Returns INPUT_SOURCE_BUTTONS and/or INPUT_SOURCE_SWITCHES for
+            what fired, 0 on timeout, -1 on error.
+            
+        Last modified: October 17th, 2026
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+int waitForInput(int timeout_ms) {
+
+#ifdef __linux__
+    const unsigned int window[2] = {BUTTONS_ADDR, SWITCHES_ADDR};
+    const int source[2] = {INPUT_SOURCE_BUTTONS, INPUT_SOURCE_SWITCHES};
+    struct pollfd fds[2];
+    unsigned long long events; // eventfd counter
+    unsigned int irqs;         // UIO interrupt count
+    const unsigned int unmask = 1;
+    int nfds = 0;
+    int n = 0;
+    int fired = 0;
+    int c;
+
+    if(klib_input_event_fd >= 0) {
+        // the fake interrupt, its counter carries the INPUT_SOURCE_* bits of what fired
+        fds[0].fd = klib_input_event_fd;
+        fds[0].events = POLLIN;
+        nfds = 1;
+    } else {
+        for(c = 0; c < 2; c++) {
+            fds[c].fd = klib_window_fd[klibWindow(window[c])];
+            fds[c].events = POLLIN;
+            if(fds[c].fd < 0) {
+                return -1; // not mapped through UIO, there is no interrupt to wait on
+            }
+
+            // UIO masks the interrupt after every delivery, unmask it before sleeping
+            if(write(fds[c].fd, &unmask, sizeof(unmask)) != sizeof(unmask)) {
+                return -1;
+            }
+        }
+        nfds = 2;
+    }
+
+    n = poll(fds, nfds, timeout_ms);
+    if(n <= 0) {
+        return n;
+    }
+
+    if(klib_input_event_fd >= 0) {
+        if(read(fds[0].fd, &events, sizeof(events)) != sizeof(events)) {
+            return -1;
+        }
+        fired = (int)(events & (INPUT_SOURCE_BUTTONS | INPUT_SOURCE_SWITCHES));
+    } else {
+        for(c = 0; c < 2; c++) {
+            if(fds[c].revents & POLLIN) {
+                if(read(fds[c].fd, &irqs, sizeof(irqs)) != sizeof(irqs)) {
+                    return -1;
+                }
+                fired |= source[c];
+            }
+        }
+    }
+
+    // acknowledge in the AXI GPIO block so the next edge raises a new interrupt
+    for(c = 0; c < 2; c++) {
+        if(fired & source[c]) {
+            mmioWrite(window[c] + AXI_GPIO_IP_ISR, mmioRead(window[c] + AXI_GPIO_IP_ISR));
+        }
+    }
+
+    return fired;
+#else
+    (void)timeout_ms;
+    return -1;
+#endif
+}//end waitForInput()
\ No newline at end of file
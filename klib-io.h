@@ -4,14 +4,14 @@
 								Klib-io (for RealDigital Blackboard)
                                 
         Version:                
-								1.1.2 (Header file)
+								1.2.0 (Header file)
 
         Contributor(s):         
 								Koby Miller
                                 Dr. Jacob Murray
 
         Date last modified:     
-								February 15th, 2024
+								October 17th, 2026
 
         Description:            
 								A library including useful functions concerning the RealDigital Blackboard, such as functions to use
@@ -28,8 +28,32 @@
                                 Please read function descriptions below for use.
 
         Changelog:              
-								Added SEVSEG_CHAR_UNDERSCORE character support
-                                Changed mode parameter for outputToSevSeg(); to byte to support binary display mode
+								Added register access backends (bare-metal, /dev/mem, UIO, simulated) through initKlibIo();
+                                Added write-elision shadow registers with hit/miss counters (getShadowStats();)
+                                Replaced the outputToSevSegCustom(); switch-case with a compile-time glyph table (encodeSevSeg();, outputToSevSegFrame();)
+                                Division-free decimal mode for outputToSevSeg(); with negative and overflow display
+                                Added a non-blocking scrolling marquee for long text (initMarquee();, tickMarquee();)
+                                Added a double-buffered board frame committed with one minimal burst of writes (commitBoardFrame();)
+                                Added a debounce/edge-detection input engine with a lock-free event queue (initInputEngine();)
+                                Added interrupt-driven input through AXI GPIO interrupts and UIO (waitForInput();)
+                                Added an integer-only, gamma-corrected RGB path (outputToRGBFixed();), outputToRGB(); now wraps it
+                                Added a non-blocking RGB animation engine for fades, breathing and color cycles (tickRGBAnimation();)
+                                PMOD B row direction is cached, added pmodReadFast(); and pmodWriteFast();
+                                pmodWrite(); sets a row with one atomic store to MASK_DATA_2_LSW
+                                Added burst PMOD B streaming (pmodWriteBurst();, pmodReadBurst();)
+                                Added a PMOD B logic analyzer with triggers, run-length encoded capture and VCD export (runPmodCapture();)
+                                Added software SPI (modes 0-3), I2C and UART engines over PMOD B (pmodSpiTransfer();, pmodI2cWrite();, pmodUartWrite();)
+                                Added a calibrated timing module on the ARM global timer (getNanos();, delayNs();, waitUntilNs();, getTimingStats();)
+                                Added a JSON microbenchmark suite (klib-io-bench.c) and optional bus access counters (getMmioCounts();)
+                                Added optional MMIO tracing with per-register counters, a lock-free trace ring and a summary dump (dumpMmioSummary();)
+                                Added header-only inline accessors over typed register structs behind KLIB_IO_INLINE
+                                Added optional per-peripheral locks for multi-threaded programs (lockPeripheral();, modifyReg();) behind KLIB_IO_THREADSAFE
+                                Added a lock-free async output queue with last-writer-wins coalescing and an I/O thread (queueSevSeg();, flushOutputQueue();, startOutputThread();)
+                                Added a frame-rate-capped display sink for the seven-segment display and LEDs (sinkSevSeg();, flushDisplaySink();)
+                                Added SIMD batch encoders for seven-segment frames (encodeSevSegValues();, encodeSevSegStrings();) with a scalar reference
+                                Added fixed-point and float display with a lit decimal point (outputToSevSegFixed();, outputToSevSegFloat();)
+                                Added per-digit updates that patch the cached frame (setSevSegDigit();, setSevSegChar();, clearSevSegDigit();, setSevSegPoint();)
+                                Added loopback tests for SPI, UART and I2C (klib-io-test.c) and a simulated I2C slave (simPmodI2cSlave();)
 
 
 
@@ -45,10 +69,20 @@
 +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
 
 #include <math.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
-#include <sys/_intsup.h>
+#if defined(__has_include)
+    #if __has_include(<sys/_intsup.h>) // newlib only, not present on PetaLinux/host glibc
+        #include <sys/_intsup.h>
+    #endif
+#endif
 #include <unistd.h>
 #include <time.h>
+#include <stdatomic.h>
+#ifdef __linux__
+    #include <pthread.h>
+#endif
 
 /* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
   
@@ -64,12 +98,96 @@
 #define false 0
 #define bool char // must. have. boolean. This is still 8-bits
 
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+    Register access backend
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+#define KLIB_BACKEND_BAREMETAL 0        // Dereference physical addresses directly (default)
+#define KLIB_BACKEND_DEVMEM 1           // mmap() every peripheral window through /dev/mem
+#define KLIB_BACKEND_UIO 2              // mmap() every peripheral window through its /dev/uioN
+#define KLIB_BACKEND_SIM 3              // In-process simulated register file (host builds)
+
+#define KLIB_WINDOW_SIZE 0x1000         // Size of each mapped peripheral window
+#define KLIB_WINDOW_COUNT 6             // Number of peripheral windows used by the library
+// index of each window in the mapping table
+    #define KLIB_WINDOW_BUTTONS 0
+    #define KLIB_WINDOW_LEDS 1
+    #define KLIB_WINDOW_SWITCHES 2
+    #define KLIB_WINDOW_RGB 3
+    #define KLIB_WINDOW_SEVSEG 4
+    #define KLIB_WINDOW_GPIO_PS 5
+
+// Build options for bus instrumentation, both compile to nothing when left undefined:
+//      KLIB_IO_COUNT_MMIO      total register reads/writes (getMmioCounts())
+//      KLIB_IO_TRACE           per-register counters and a trace ring (dumpMmioSummary()), implies KLIB_IO_COUNT_MMIO
+#if defined(KLIB_IO_TRACE) && !defined(KLIB_IO_COUNT_MMIO)
+    #define KLIB_IO_COUNT_MMIO
+#endif
+#ifndef KLIB_TRACE_SIZE
+    #define KLIB_TRACE_SIZE 4096        // Records kept by the trace ring, power of 2
+#endif
+// trace record operations
+    #define KLIB_TRACE_READ 0           // One load, value is what was read
+    #define KLIB_TRACE_WRITE 1          // One store, value is what was written
+    #define KLIB_TRACE_BURST_READ 2     // Back-to-back loads, value is how many
+    #define KLIB_TRACE_BURST_WRITE 3    // Back-to-back stores, value is how many
+
+// Build option for multi-threaded programs, compiles to nothing when left undefined:
+//      KLIB_IO_THREADSAFE      one lock per peripheral around every read-modify-write (lockPeripheral())
+// peripheral lock indices, locks are always taken in ascending order
+    #define KLIB_PERIPH_LEDS 0          // LED register
+    #define KLIB_PERIPH_SEVSEG 1        // Seven-segment ctrl/data
+    #define KLIB_PERIPH_RGB1 2          // RGB LED 1 channels
+    #define KLIB_PERIPH_RGB2 3          // RGB LED 2 channels
+    #define KLIB_PERIPH_PMOD 4          // PMOD B direction/output enable and the engines using them
+    #define KLIB_PERIPH_COUNT 5
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+    Timing
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+#define GTIMER_PAGE 0xF8F00000          // SCU page holding the ARM global timer
+#define GTIMER_COUNT_LO 0xF8F00200      // Global timer counter, lower 32 bits
+#define GTIMER_COUNT_HI 0xF8F00204      // Global timer counter, upper 32 bits
+#define GTIMER_CTRL 0xF8F00208          // Global timer control, bit 0 enables the counter
+#ifndef KLIB_GTIMER_HZ
+    #define KLIB_GTIMER_HZ 333333333ULL // Global timer clock (CPU_3x2x, half the 667 MHz CPU clock)
+#endif
+
 /* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
     Switches
 +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
 #define BUTTONS_ADDR 0x41200000	        // Address of Buttons 
 #define SWITCHES_ADDR 0x41220000        // Address of Switches 
 
+// AXI GPIO interrupt registers, offsets from BUTTONS_ADDR / SWITCHES_ADDR
+#define AXI_GPIO_GIER 0x11C             // Global interrupt enable, bit 31
+#define AXI_GPIO_IP_ISR 0x120           // Interrupt status, write 1 to clear
+#define AXI_GPIO_IP_IER 0x128           // Interrupt enable, bit 0 for channel 1
+
+    #define INPUT_SOURCE_BUTTONS 0b01       // waitForInput() result bits
+    #define INPUT_SOURCE_SWITCHES 0b10
+
+// Input engine: buttons are inputs 0-3, switches are inputs 4-15
+#define INPUT_BUTTON(n) (n)
+#define INPUT_SWITCH(n) (4 + (n))
+#define INPUT_COUNT 16
+#define INPUT_HOLD_MASK 0xF             // Inputs that send INPUT_EVENT_HOLD/REPEAT, the buttons
+#define INPUT_QUEUE_SIZE 64             // Events held between sampler and application, power of 2
+
+    #define INPUT_EVENT_PRESS 0             // Input became active (debounced)
+    #define INPUT_EVENT_RELEASE 1           // Input became inactive (debounced)
+    #define INPUT_EVENT_HOLD 2              // Input has been active for hold_ms
+    #define INPUT_EVENT_REPEAT 3            // Input is still active, every repeat_ms after the hold
+
+// Async output queue (see initOutputQueue())
+#define OUTPUT_PERIOD_US 1000           // Default time between flushes of the I/O thread
+    #define OUTPUT_CMD_LEDS 0               // outputToLEDs(value)
+    #define OUTPUT_CMD_SEVSEG 1             // outputToSevSeg(value, arg)
+    #define OUTPUT_CMD_SEVSEG_CUSTOM 2      // outputToSevSegCustom(), the 4 characters packed into value
+    #define OUTPUT_CMD_RGB 3                // outputToRGBFixed(arg, value, bright)
+
+// Frame-rate-capped display sink (see initDisplaySink())
+#define DISPLAY_SINK_HZ 60              // Default refresh cap
+
 /* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
     Seven-segment display
 +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
@@ -119,6 +237,10 @@
     #define SEVSEG_CHAR_EQUAL 0b0110111
     #define SEVSEG_CHAR_UNDERSCORE 0b1110111
 
+#define SEVSEG_MARQUEE_LOOP 0           // Scroll right to left forever, one blank between repeats
+#define SEVSEG_MARQUEE_PINGPONG 1       // Scroll to the end of the text, then back to the start
+#define SEVSEG_MARQUEE_ONESHOT 2        // Scroll to the end of the text once and stop there
+
 /* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
     LEDs
 +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
@@ -127,6 +249,9 @@
 /* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
     RBG LEDs
 +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+#define RGB_BRIGHT8(b) ((unsigned short)((b) * 257))  // 0 - 255 brightness for outputToRGBFixed()
+#define RGB_ANIM_STEPS 256              // Keyframes per animation, power of 2
+
 #define RGB_EN_BASEADDR 0x43C00000
 // increment by 0x10, 16, 0b00010000
     #define RGB_EN_1B_ADDR 0x43C00000             // Address of RGB LED ENABLE #1    BLUE
@@ -158,7 +283,11 @@
     PMOD
 +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
 
+#define GPIO_PS_BASEADDR 0xE000A000     // Base address of the Zynq PS GPIO controller
+
 // PMOD B
+#define MASK_DATA_2_LSW 0xE000A010      // Masked write of bank 2 pins 0-15: [31:16] pins to keep, [15:0] data
+#define MASK_DATA_2_MSW 0xE000A014      // Masked write of bank 2 pins 16-31, same layout
 #define DATA_2 0xE000A048
 #define DATA_2_RO 0xE000A068
 #define DIR_2 0xE000A284
@@ -167,6 +296,250 @@
 #define PMODB_TOP_MASK 0x0780
 #define PMODB_BOTTOM_MASK 0x7800
 
+// PMOD B pins are numbered top row 0-3, bottom row 4-7 by the pin-level functions below
+#define PMODB_PIN(row, n) ((row) * 4 + (n))
+
+// PMOD B capture triggers
+#define PMOD_TRIGGER_NONE 0             // Start capturing immediately
+#define PMOD_TRIGGER_RISING 1           // Any pin in the mask goes 0 -> 1
+#define PMOD_TRIGGER_FALLING 2          // Any pin in the mask goes 1 -> 0
+#define PMOD_TRIGGER_EDGE 3             // Any pin in the mask changes
+#define PMOD_TRIGGER_PATTERN 4          // Pins in the mask match the pattern
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+  
+        TYPES
+
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+    Register layouts, for typed access through the *_REGS pointers
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+typedef struct {
+    volatile unsigned int data;             // 0x000 GPIO_DATA
+    volatile unsigned int tri;              // 0x004 GPIO_TRI
+} klibAxiGpioRegs;
+
+typedef struct {
+    volatile unsigned int ctrl;             // 0x0 SEVSEG_CTRL_ADDR
+    volatile unsigned int data;             // 0x4 SEVSEG_DATA_ADDR
+} klibSevSegRegs;
+
+typedef struct {
+    volatile unsigned int en;               // 0x0 RGB_EN_*
+    volatile unsigned int period;           // 0x4 RGB_PERIOD_*
+    volatile unsigned int width;            // 0x8 RGB_WIDTH_*
+    unsigned int reserved;
+} klibRgbChannelRegs;
+
+typedef struct {
+    klibRgbChannelRegs ch[6];               // LED 1 blue, green, red, then LED 2 blue, green, red
+} klibRgbRegs;
+
+typedef struct {
+    unsigned int reserved0[4];
+    volatile unsigned int mask_data_2_lsw;  // 0x010 MASK_DATA_2_LSW
+    volatile unsigned int mask_data_2_msw;  // 0x014 MASK_DATA_2_MSW
+    unsigned int reserved1[12];
+    volatile unsigned int data_2;           // 0x048 DATA_2
+    unsigned int reserved2[7];
+    volatile unsigned int data_2_ro;        // 0x068 DATA_2_RO
+    unsigned int reserved3[134];
+    volatile unsigned int dirm_2;           // 0x284 DIR_2
+    volatile unsigned int oen_2;            // 0x288 OE_2
+} klibGpioPsRegs;
+
+// Physical register blocks (bare-metal addresses, see the header-only accessors at the end of this file)
+#define BUTTONS_REGS ((klibAxiGpioRegs*)BUTTONS_ADDR)
+#define SWITCHES_REGS ((klibAxiGpioRegs*)SWITCHES_ADDR)
+#define LED_REGS ((klibAxiGpioRegs*)LED_ADDR)
+#define SEVSEG_REGS ((klibSevSegRegs*)SEVSEG_CTRL_ADDR)
+#define RGB_REGS ((klibRgbRegs*)RGB_EN_BASEADDR)
+#define GPIO_PS_REGS ((klibGpioPsRegs*)GPIO_PS_BASEADDR)
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+    MMIO trace record (see readMmioTrace())
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+typedef struct {
+    unsigned long long ns;          // getNanos() time of the access
+    unsigned int addr;              // physical address
+    unsigned int value;             // value read or written, access count for bursts
+    byte op;                        // KLIB_TRACE_*
+} mmioTraceRecord;
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+    Timing calibration (see getTimingStats())
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+typedef struct {
+    unsigned int clock_ns;          // cost of one getNanos() call
+    unsigned int resolution_ns;     // smallest step getNanos() was seen to take
+    unsigned int spin_jitter_ns;    // worst overshoot of delayNs()
+    unsigned int sleep_jitter_ns;   // worst overshoot of a short sleep, 0 where the OS can't sleep
+    unsigned int spin_below_ns;     // waitUntilNs() spins through waits shorter than this
+    bool global_timer;              // getNanos() reads the ARM global timer, not clock_gettime()
+} klibTiming;
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+    Seven-segment marquee (see initMarquee())
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+typedef struct {
+    unsigned char* glyphs;      // pre-encoded text, one SEVSEG_DATA byte per character
+    unsigned int length;        // number of glyphs (at least 4)
+    unsigned int pos;           // index of the leftmost visible glyph
+    unsigned int frame;         // SEVSEG_DATA word currently shown
+    unsigned long step_ms;      // time between steps
+    unsigned long next_ms;      // getMillis() time of the next step
+    byte mode;                  // SEVSEG_MARQUEE_LOOP, _PINGPONG or _ONESHOT
+    bool started;               // first window has been shown
+    bool reverse;               // ping-pong is heading back to the start
+    bool done;                  // one-shot reached the end
+} sevSegMarquee;
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+    Board frame (see commitBoardFrame())
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+// RGB arrays are in register order: 1B, 1G, 1R, 2B, 2G, 2R
+typedef struct {
+    unsigned int led;               // LED_ADDR
+    unsigned int sevseg_ctrl;       // SEVSEG_CTRL_ADDR
+    unsigned int sevseg_data;       // SEVSEG_DATA_ADDR
+    unsigned int rgb_en[6];         // RGB_EN_*_ADDR
+    unsigned int rgb_period[6];     // RGB_PERIOD_*_ADDR
+    unsigned int rgb_width[6];      // RGB_WIDTH_*_ADDR
+} boardFrame;
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+    Input engine (see initInputEngine())
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+typedef struct {
+    unsigned long time;         // getMillis() time of the sample that produced it
+    byte input;                 // INPUT_BUTTON(n) or INPUT_SWITCH(n)
+    byte type;                  // INPUT_EVENT_*
+} inputEvent;
+
+typedef struct {
+    unsigned int state;                     // debounced inputs, one bit each
+    unsigned int cnt0;                      // vertical counter, low bit of every input
+    unsigned int cnt1;                      // vertical counter, high bit of every input
+    unsigned int hold_ticks;                // samples until INPUT_EVENT_HOLD, 0 for none
+    unsigned int repeat_ticks;              // samples between INPUT_EVENT_REPEAT, 0 for none
+    unsigned int sample_us;                 // sampler thread period
+    unsigned int held[INPUT_COUNT];         // samples each input has been active
+    inputEvent queue[INPUT_QUEUE_SIZE];     // single-producer/single-consumer ring
+    atomic_uint head;                       // written by the sampler only
+    atomic_uint tail;                       // written by the application only
+    unsigned long dropped;                  // events lost to a full queue
+    atomic_bool running;                    // sampler thread should keep going
+#ifdef __linux__
+    pthread_t thread;
+#endif
+} inputEngine;
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+    Async output queue (see initOutputQueue())
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+typedef struct {
+    atomic_ullong cmd;          // newest command, packed with the pending flag (see queueOutput())
+    atomic_ulong coalesced;     // commands replaced here before a flush wrote them
+} outputSlot;
+
+typedef struct {
+    outputSlot latest[KLIB_PERIPH_RGB2 + 1];    // one slot per display peripheral
+    atomic_flag flushing;                       // held by the one flushOutputQueue() running
+    atomic_ulong written;                       // commands that reached the hardware
+    unsigned int period_us;                     // I/O thread period
+    atomic_bool running;                        // I/O thread should keep going
+#ifdef __linux__
+    pthread_t thread;
+#endif
+} outputQueue;
+
+typedef struct {
+    unsigned long submitted;    // commands accepted from producers
+    unsigned long written;      // commands that reached the hardware
+    unsigned long coalesced;    // commands superseded before a flush, never written
+    unsigned int pending;       // peripherals waiting for the next flush
+    float ratio;                // submitted / written, 0 before the first write
+} outputQueueStats;
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+    Display sink (see initDisplaySink())
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+typedef struct {
+    unsigned long long frame_ns;    // shortest time between two renders
+    unsigned long long next_ns;     // getNanos() time the next render may happen
+    int sevseg_val;                 // pending seven-segment number
+    char sevseg_chars[4];           // pending seven-segment text
+    byte sevseg_mode;               // outputToSevSeg() mode of the pending number
+    bool sevseg_custom;             // the pending value is text, not a number
+    bool sevseg_dirty;              // a seven-segment value waits for the next render
+    int led_val;                    // pending LED value
+    bool led_dirty;                 // an LED value waits for the next render
+    unsigned long submitted;        // values handed to the sink
+    unsigned long rendered;         // values that were converted and written
+} displaySink;
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+    RGB animation (see tickRGBAnimation())
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+typedef struct {
+    unsigned short width[RGB_ANIM_STEPS][3];  // precomputed PWM widths, blue, green, red
+    unsigned int select;                      // LED the animation drives
+    unsigned long period_ms;                  // length of one pass through the table
+    unsigned long long rate;                  // keyframes per ms in Q32, exact enough for periods of days
+    unsigned long start_ms;                   // getMillis() time of keyframe 0
+    bool loop;                                // restart after the last keyframe
+    bool started;                             // start_ms is set
+    bool done;                                // a non-looping animation reached the end
+} rgbAnimation;
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+    PMOD B capture (see runPmodCapture())
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+typedef struct {
+    uint32_t sample;            // index of the first sample of this run
+    uint8_t pins;               // top row in bits 0-3, bottom row in bits 4-7
+} pmodRun;
+
+typedef struct {
+    pmodRun* runs;              // ring of run-length encoded samples
+    unsigned int capacity;      // size of the ring
+    unsigned int head;          // next run to write
+    unsigned int count;         // runs held, at most capacity
+    uint32_t samples;           // samples taken by the last capture
+    uint32_t trigger_sample;    // sample the trigger fired on
+    unsigned long long ns;      // duration of the last capture
+    byte trigger;               // PMOD_TRIGGER_*
+    uint8_t mask;               // pins the trigger looks at
+    uint8_t pattern;            // pin values for PMOD_TRIGGER_PATTERN
+} pmodCapture;
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+    PMOD B software SPI / I2C / UART (see initPmodSpi(), initPmodI2c(), initPmodUart())
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+typedef struct {
+    unsigned int miso_bit;      // MISO in DATA_2_RO
+    byte mode;                  // SPI mode 0-3, CPOL in bit 1, CPHA in bit 0
+    unsigned int half_ns;       // half a clock period
+    unsigned int word[2][2];    // MASK_DATA_2_LSW words, indexed [mosi][sck]
+    unsigned int cs_word[2];    // MASK_DATA_2_LSW words, chip select low/high
+} pmodSpi;
+
+typedef struct {
+    unsigned int quarter_ns;    // quarter of a clock period
+    unsigned int sda_bit;       // SDA in DATA_2_RO
+    unsigned int scl_bit;       // SCL in DATA_2_RO
+    unsigned long long t;       // deadline of the next edge
+    bool scl_low;               // lines currently pulled low
+    bool sda_low;
+} pmodI2c;
+
+typedef struct {
+    unsigned int bit_ns;        // one bit period
+    unsigned int word[2];       // MASK_DATA_2_LSW words for TX low/high
+    unsigned int rx_bit;        // RX in DATA_2_RO
+} pmodUart;
+
 /* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
   
         FUNCTION PROTOTYPES
@@ -209,6 +582,262 @@ bool bitIndex(int num, unsigned int place);
 +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
 int intPow(int num,int power);
 
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        getMillis();
+
+            Returns a monotonic millisecond count, for the tick functions
+            of the non-blocking engines (e.g. tickMarquee())
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+unsigned long getMillis();
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        initKlibIo();
+		
+        byte backend            KLIB_BACKEND_BAREMETAL, _DEVMEM, _UIO or _SIM
+
+            Maps every peripheral window once and caches the base pointers,
+            so each register access afterwards is a single load or store.
+            Calling it again switches backends. Without a call, the library
+            behaves as before and dereferences physical addresses directly.
+
+            KLIB_BACKEND_SIM backs every window with zeroed memory so the
+            library can run (and be measured) on a host machine.
+
+            Returns 0 on success, -1 on failure (bare-metal is left selected).
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+int initKlibIo(byte backend);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        closeKlibIo();
+
+            Unmaps every peripheral window (or frees the simulated register
+            file) and returns to the bare-metal backend
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void closeKlibIo();
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        readReg();
+		
+        unsigned int addr       Physical address of the register (e.g. LED_ADDR)
+
+            Reads a register through the active backend.
+            Addresses outside the mapped windows read as 0.
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+unsigned int readReg(unsigned int addr);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        writeReg();
+		
+        unsigned int addr       Physical address of the register (e.g. LED_ADDR)
+        unsigned int val        Value to store
+
+            Writes a register through the active backend.
+            Addresses outside the mapped windows are ignored.
+            The store is never elided, but the shadow copy is updated.
+            Mostly useful to poke inputs (buttons, switches) in the simulator.
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void writeReg(unsigned int addr, unsigned int val);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        modifyReg();
+		
+        unsigned int addr       Physical address of the register (e.g. DIR_2)
+        unsigned int clear      Bits to clear
+        unsigned int set        Bits to set, applied after 'clear'
+
+            Read-modify-write of one register. With KLIB_IO_THREADSAFE the
+            whole sequence holds the owning peripheral's lock, so two threads
+            changing different bits of the same register never lose an update.
+            Shadowed registers are read from the shadow and the store is
+            skipped when nothing changes.
+            Returns the new register value, 0 outside the mapped windows.
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+unsigned int modifyReg(unsigned int addr, unsigned int clear, unsigned int set);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        lockPeripheral();
+		
+        byte periph             Peripheral to claim (KLIB_PERIPH_LEDS .. KLIB_PERIPH_PMOD)
+
+            Every library call already locks the peripheral it touches, one
+            lock per peripheral, so threads driving different peripherals
+            never wait on each other. This holds the lock across several
+            calls instead (e.g. a whole I2C transaction sequence, or a
+            setupPmod() + pmodWrite() pair). The locks are recursive, so the
+            owner keeps calling the library as usual. Take several locks in
+            ascending KLIB_PERIPH_* order.
+
+            pmodWriteFast()/pmodReadFast(), the SPI and UART engines and
+            runPmodCapture() take no lock: their pin writes go through
+            MASK_DATA_2_LSW, which the hardware applies atomically per pin.
+            The simulator's PMOD pin model is not thread-safe.
+            Shadow hit/miss statistics are approximate under contention.
+
+            Compiles to nothing without KLIB_IO_THREADSAFE.
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void lockPeripheral(byte periph);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        unlockPeripheral();
+		
+        byte periph             Peripheral to release
+
+            Releases one lockPeripheral() claim by the calling thread.
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void unlockPeripheral(byte periph);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        invalidateShadow();
+
+            The library keeps a shadow copy of every register it writes
+            (LEDs, seven-segment, RGB, DIR_2/OE_2). Stores of an
+            unchanged value are skipped and read-modify-writes are served
+            from the copy.
+
+            This forgets every shadowed value, so the next access of each
+            goes to the bus. Use after something outside this library
+            (another process, a reset) changed the output registers.
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void invalidateShadow();
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        getShadowStats();
+		
+        unsigned long* hits         Accesses served by the shadow (elided stores and cached reads)
+        unsigned long* misses       Accesses that went to the bus
+
+            Either pointer may be NULL. Counters are cleared with resetShadowStats()
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void getShadowStats(unsigned long* hits, unsigned long* misses);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        resetShadowStats();
+
+            Clears the shadow hit/miss counters
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void resetShadowStats();
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        getMmioCounts();
+		
+        unsigned long* reads        Register loads issued by the library
+        unsigned long* writes       Register stores issued by the library
+
+            Bus transaction totals for profiling. They are only counted when
+            the library is built with -DKLIB_IO_COUNT_MMIO, otherwise both
+            stay 0 and the accesses carry no overhead. Either pointer may be NULL.
+        
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void getMmioCounts(unsigned long* reads, unsigned long* writes);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        resetMmioCounts();
+
+            Clears the bus transaction totals, and with KLIB_IO_TRACE the
+            per-register counters and the trace ring. initKlibIo() calls it.
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void resetMmioCounts();
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        readMmioTrace();
+		
+        mmioTraceRecord* out        Filled with the most recent accesses, oldest first
+        unsigned int max            Room in 'out'
+
+            Copies the trace ring (KLIB_IO_TRACE builds only). Producers
+            claim slots with one atomic add and never wait, so a record
+            being written during the copy can come out torn.
+            Returns the number of records copied, 0 without KLIB_IO_TRACE.
+        
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+unsigned int readMmioTrace(mmioTraceRecord* out, unsigned int max);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        dumpMmioSummary();
+		
+        const char* path            File to write, NULL for stdout
+
+            Writes a table of every register the library touched since
+            resetMmioCounts(): reads, writes and redundant writes (same
+            value as the previous store), in total and per second, hottest
+            first. Redundant writes point at stores worth eliding.
+            Returns 0 on success, -1 without KLIB_IO_TRACE or if the file
+            could not be written.
+        
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+int dumpMmioSummary(const char* path);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        getNanos();
+
+            Monotonic nanosecond clock. On the board (bare-metal and
+            /dev/mem backends) it reads the 64-bit ARM global timer, so it
+            is cycle-accurate and costs two loads. Elsewhere, or when
+            initKlibIo() finds the counter stopped, it falls back to
+            clock_gettime(CLOCK_MONOTONIC).
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+unsigned long long getNanos();
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        delayNs();
+		
+        unsigned long ns            Nanoseconds to wait
+
+            Busy-waits for 'ns', corrected for the measured cost of reading
+            the clock. Accuracy is bounded by the spin jitter reported by
+            getTimingStats().
+        
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void delayNs(unsigned long ns);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        waitUntilNs();
+		
+        unsigned long long deadline getNanos() time to wait for
+
+            Deadline wait for periodic work: waiting for absolute times
+            keeps a loop from drifting. Sleeps through the part of the wait
+            that is longer than the measured sleep jitter, then spins the
+            rest, so long waits free the CPU and short ones stay precise.
+        
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void waitUntilNs(unsigned long long deadline);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        calibrateTiming();
+
+            Measures the clock cost and resolution and the jitter of spinning
+            and sleeping, which delayNs() and waitUntilNs() then rely on.
+            initKlibIo() runs it; call it again after changing CPU frequency
+            or scheduling policy. Takes a few milliseconds.
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void calibrateTiming();
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        getTimingStats();
+		
+        klibTiming* t               Filled with the last calibration
+
+            Reports the measured jitter, to choose between sleeping and
+            spinning for a given interval
+        
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void getTimingStats(klibTiming* t);
+
 /* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
         getButtonStates();
             
@@ -252,6 +881,11 @@ void enableSevSeg(unsigned int mode);
         byte mode               Display mode. 0-hexadecimal, 1-decimal, 2-binary
             
             Used to display data on the seven-segment display
+
+            In decimal mode, -999 to -1 are shown with a leading dash and
+            values outside -999 to 9999 show "----". Digits are produced
+            without division; build with KLIB_SEVSEG_DEC_TABLE to use a
+            40KB table of precomputed frames instead.
             
         Written by Koby Miller
 +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
@@ -266,85 +900,1185 @@ void outputToSevSeg(int val, byte mode);
             Any non-supported character will be blank. If a letter is only available
             in either upper or lower case, both upper and lower case inputs will 
             use the only available one.
+            Strings shorter than 4 characters are padded with blanks.
             
         Written by Koby Miller
-        Last modified: January 30th, 2024
 +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
 void outputToSevSegCustom(const char* str);
 
 /* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-        outputToLEDs();
+        encodeSevSegChars();
 		
-        int val       Value to push to the LEDs
+        const char* chars       Exactly 4 characters, NUL is not treated specially
+
+            Returns the 32-bit SEVSEG_DATA word (custom mode) for the four
+            characters, leftmost character in the most significant byte.
+            Four table loads and no branches.
             
-            Used to display data on LEDs
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+unsigned int encodeSevSegChars(const char* chars);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        encodeSevSeg();
+		
+        const char* str         Input string, only first 4 characters are used
+
+            Returns the 32-bit SEVSEG_DATA word (custom mode) for a string.
+            Strings shorter than 4 characters are padded with blanks.
+            Encode once and pass the result to outputToSevSegFrame() to show
+            the same text repeatedly without re-encoding it.
             
-        Written by Koby Miller
 +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
-void outputToLEDs(int val);
+unsigned int encodeSevSeg(const char* str);
 
 /* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-        enableRGB();
+        encodeSevSegValue();
+		
+        int val                 Value to encode
+        byte mode               0-hexadecimal, 1-decimal, 2-binary, as for outputToSevSeg()
 
-        unsigned int select     Binary number to enable each LED    
+            Returns the custom-mode SEVSEG_DATA word showing what
+            outputToSevSeg() would show for 'val' (leading zeros, leading
+            dash, "----" out of range), for outputToSevSegFrame().
+            The scalar reference encodeSevSegValues() is checked against.
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+unsigned int encodeSevSegValue(int val, byte mode);
 
-            Used to enable RGB LEDs.
-            enableRGB(0b11) enables both LEDs
-            enableRGB(0b10) enables only second LED
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        encodeSevSegValues();
+		
+        const int* vals         Values to encode
+        unsigned int* frames    Receives one frame per value
+        size_t n                Number of values
+        byte mode               0-hexadecimal, 1-decimal, 2-binary
+
+            Batch version of encodeSevSegValue() for precomputing replays
+            and animations. Uses AVX2 (16 values a step), SSSE3 (8) or NEON
+            (8) when the compiler targets them (-mavx2, -mssse3 or
+            -march=native on hosts, -mfpu=neon on the Zynq), and a scalar
+            loop otherwise; getSevSegBatchPath() tells which one was built.
+            Decimal digits come from a multiply by 0xCCCD on 16-bit lanes
+            and a shuffle through a 16-entry glyph table, no division.
             
-        Written by Koby Miller
 +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
-void enableRGB(unsigned int select);
+void encodeSevSegValues(const int* vals, unsigned int* frames, size_t n, byte mode);
 
 /* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-        outputToRGB();
+        encodeSevSegStrings();
 		
-        unsigned int select         Picks which LED to send to 
-        unsigned int color          HEX color to display (0xNNNNNN)
-        float bright                0.0 - 1.0 value to determine brightness of LED
+        const char* text        n records of exactly 4 characters, no separators
+        unsigned int* frames    Receives one frame per record
+        size_t n                Number of records
 
-            Used to display light on RGB LEDs
+            Batch version of encodeSevSegChars(), same result for every
+            record. The SIMD paths look up 16 (SSSE3), 32 (AVX2) or
+            8 (NEON) characters at a time in the glyph table.
             
-        Written by Koby Miller
 +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
-void outputToRGB(unsigned int select, unsigned int color, float bright);
+void encodeSevSegStrings(const char* text, unsigned int* frames, size_t n);
 
 /* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-        setupPmod();
+        getSevSegBatchPath();
+
+            Returns the instruction set the batch encoders were built for:
+            "avx2", "ssse3", "neon" or "scalar"
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+const char* getSevSegBatchPath();
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        encodeSevSegFixed();
 		
-        bool io             read (0) or write (1)
-        bool row            top (0) or bottom (1) row
+        int val                 Fixed-point value, e.g. 1234 for 12.34
+        unsigned int decimals   Digits of 'val' after the decimal point
 
-            Enables the mode of PMOD B
-        
-        Written by Koby Miller
-        Originally written by Dr. Jacob Murray
+            Returns the custom-mode frame showing 'val' right-aligned with
+            its decimal point lit: 1234, 2 shows "12.34"; 5, 1 shows "0.5";
+            -35, 1 shows "-3.5". Negative values get SEVSEG_CHAR_DASH right
+            in front of the first digit. Fraction digits that don't fit are
+            rounded away (123456, 3 shows "123.5"), and values whose
+            integer part doesn't fit show "----".
+            Integer-only: multiplies and shifts, no division, no printf.
+            
 +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
-void setupPmod(bool io, bool row);
+unsigned int encodeSevSegFixed(int val, unsigned int decimals);
 
 /* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-        pmodRead();
+        encodeSevSegFloat();
 		
-        bool row            top (0) or bottom (1) row
+        float val               Value to show
 
-            Returns a 4-bit value from the PMOD B row selected
-        
-        Written by Koby Miller
-        Originally written by Dr. Jacob Murray
+            Returns the custom-mode frame for 'val' with as many decimals
+            as fit: 3.14159 shows "3.142", -3.5 shows "-3.50", 1234.5 shows
+            "1235". NaN and values too large to fit show "----".
+            One scale and round to fixed point, then encodeSevSegFixed().
+            
 +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
-unsigned int pmodRead(bool row);
+unsigned int encodeSevSegFloat(float val);
 
 /* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-        pmodWrite();
+        outputToSevSegFixed();
 		
-        bool row                top (0) or bottom (1) row
-        unsigned int data       data to be written to the selected PMOD B row       
+        int val                 Fixed-point value, e.g. 1234 for 12.34
+        unsigned int decimals   Digits of 'val' after the decimal point
 
-            Writes a 4-bit value to the PMOD B row selected
-        
-        Written by Koby Miller
-        Originally written by Dr. Jacob Murray
+            Shows encodeSevSegFixed(val, decimals) in custom mode
+            
 +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
-void pmodWrite(bool row, unsigned int data);
+void outputToSevSegFixed(int val, unsigned int decimals);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        outputToSevSegFloat();
+		
+        float val               Value to show
+
+            Shows encodeSevSegFloat(val) in custom mode
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void outputToSevSegFloat(float val);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        outputToSevSegFrame();
+		
+        unsigned int frame      Pre-encoded SEVSEG_DATA word (see encodeSevSeg())
+
+            Shows a pre-encoded frame in custom mode. Re-sending the frame
+            already on the display costs no bus writes.
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void outputToSevSegFrame(unsigned int frame);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        setSevSegDigit();
+		
+        byte digit              Digit to change, 0 (rightmost) to 3, others are ignored
+        unsigned int val        Hexadecimal digit value, 0-F
+
+            Changes one digit and leaves the other three, and every
+            decimal point, as they are. Works in either mode: a number-mode
+            display gets the nibble, a custom-mode display gets the glyph.
+            If the display is off it starts from a blank custom-mode frame.
+            Patches the frame cached in the SEVSEG_DATA shadow register
+            and writes it once, or not at all if the digit already shows
+            'val'. A clock only needs setSevSegDigit(0, sec % 10) each
+            second.
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void setSevSegDigit(byte digit, unsigned int val);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        setSevSegChar();
+		
+        byte digit              Digit to change, 0 (rightmost) to 3, others are ignored
+        char ch                 Character to show, as in outputToSevSegCustom()
+
+            Like setSevSegDigit(), for any supported character. A
+            number-mode display is switched to custom mode first, keeping
+            what it showed.
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void setSevSegChar(byte digit, char ch);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        clearSevSegDigit();
+		
+        byte digit              Digit to blank, 0 (rightmost) to 3, others are ignored
+
+            Blanks one digit, decimal point included. Like setSevSegChar(),
+            this switches a number-mode display to custom mode.
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void clearSevSegDigit(byte digit);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        setSevSegPoint();
+		
+        byte digit              Digit whose decimal point to change, 0 (rightmost) to 3, others are ignored
+        bool on                 1 lights the decimal point, 0 turns it off
+
+            Changes one decimal point in either mode, leaving the digits
+            as they are
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void setSevSegPoint(byte digit, bool on);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        initMarquee();
+		
+        sevSegMarquee* m        Marquee to set up
+        const char* str         Text of any length
+        unsigned long step_ms   Time each 4-character window stays up
+        byte mode               SEVSEG_MARQUEE_LOOP, _PINGPONG or _ONESHOT
+
+            Encodes 'str' once into glyph codes, so stepping only shifts
+            the 32-bit frame by one digit. Drive it with tickMarquee()
+            from the main loop and release it with freeMarquee().
+
+            Returns 0 on success, -1 if memory ran out.
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+int initMarquee(sevSegMarquee* m, const char* str, unsigned long step_ms, byte mode);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        tickMarquee();
+		
+        sevSegMarquee* m        Marquee to advance
+        unsigned long now       Current time from getMillis()
+
+            Non-blocking. Shows the first window on the first call, then
+            advances one digit each time 'step_ms' has passed.
+            Returns 1 if the display changed, 0 otherwise.
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+bool tickMarquee(sevSegMarquee* m, unsigned long now);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        resetMarquee();
+		
+        sevSegMarquee* m        Marquee to rewind
+
+            Goes back to the start of the text, the next tickMarquee() shows it
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void resetMarquee(sevSegMarquee* m);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        freeMarquee();
+		
+        sevSegMarquee* m        Marquee to release
+
+            Frees the glyph codes allocated by initMarquee()
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void freeMarquee(sevSegMarquee* m);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        readBoardFrame();
+		
+        boardFrame* f           Frame to fill
+
+            Fills a frame with what the board currently shows (taken from
+            the shadow registers), a starting point for the next draw
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void readBoardFrame(boardFrame* f);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        frameLEDs();
+		
+        boardFrame* f           Frame to draw into
+        int val                 Value to push to the LEDs
+
+            Same as outputToLEDs(), but only changes the frame
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void frameLEDs(boardFrame* f, int val);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        frameSevSeg();
+		
+        boardFrame* f           Frame to draw into
+        int val                 Value to push to the seven-segment display
+        byte mode               Display mode. 0-hexadecimal, 1-decimal, 2-binary
+
+            Same as outputToSevSeg(), but only changes the frame
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void frameSevSeg(boardFrame* f, int val, byte mode);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        frameSevSegCustom();
+		
+        boardFrame* f           Frame to draw into
+        const char* str         Input string, only first 4 characters are used
+
+            Same as outputToSevSegCustom(), but only changes the frame
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void frameSevSegCustom(boardFrame* f, const char* str);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        frameEnableRGB();
+		
+        boardFrame* f           Frame to draw into
+        unsigned int select     Binary number to enable each LED
+
+            Same as enableRGB(), but only changes the frame
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void frameEnableRGB(boardFrame* f, unsigned int select);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        frameRGB();
+		
+        boardFrame* f               Frame to draw into
+        unsigned int select         Picks which LED to send to
+        unsigned int color          HEX color to display (0xNNNNNN)
+        float bright                0.0 - 1.0 value to determine brightness of LED
+
+            Same as outputToRGB(), but only changes the frame. Any
+            nonzero 'select' picks the second LED.
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void frameRGB(boardFrame* f, unsigned int select, unsigned int color, float bright);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        commitBoardFrame();
+		
+        const boardFrame* f     Frame to show
+
+            Shows a whole frame at once. Only registers whose value differs
+            from what the board shows are written, always in the same order:
+            RGB periods, widths and enables, seven-segment ctrl and data,
+            then LEDs. A full UI refresh becomes one short burst of stores
+            instead of several separate output calls.
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void commitBoardFrame(const boardFrame* f);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        initInputEngine();
+		
+        inputEngine* e          Engine to set up
+        unsigned int sample_us  Time between samples when run by startInputSampler()
+        unsigned int hold_ms    Time a button is held until INPUT_EVENT_HOLD, 0 for none
+        unsigned int repeat_ms  Time between INPUT_EVENT_REPEATs after the hold, 0 for none
+
+            Debounces all 16 inputs (4 buttons, 12 switches) in parallel.
+            Each input needs 4 identical samples in a row to change state,
+            kept in a 2-bit vertical counter spread over two words, so one
+            sample costs a handful of bitwise operations for every input.
+            Only the buttons (INPUT_HOLD_MASK) send INPUT_EVENT_HOLD and
+            INPUT_EVENT_REPEAT; a switch left on stays quiet after its
+            press, so it can't fill the queue and crowd out button events.
+
+            Run sampleInputs() at a fixed rate yourself, or let
+            startInputSampler() do it on its own thread, and drain the
+            events with nextInputEvent().
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void initInputEngine(inputEngine* e, unsigned int sample_us, unsigned int hold_ms, unsigned int repeat_ms);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        sampleInputs();
+		
+        inputEngine* e          Engine to advance
+        unsigned long now       Current time from getMillis()
+
+            Reads the buttons and switches once, debounces them and queues
+            the resulting events. Only ever call it from one thread.
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void sampleInputs(inputEngine* e, unsigned long now);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        nextInputEvent();
+		
+        inputEngine* e          Engine to drain
+        inputEvent* ev          Filled with the oldest event
+
+            Lock-free, safe to call from one thread while another samples.
+            Returns 1 if an event was taken, 0 if the queue is empty.
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+bool nextInputEvent(inputEngine* e, inputEvent* ev);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        getDebouncedInputs();
+		
+        inputEngine* e          Engine to query
+
+            Returns the debounced state of all 16 inputs,
+            buttons in bits 0-3, switches in bits 4-15
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+unsigned int getDebouncedInputs(inputEngine* e);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        startInputSampler();
+		
+        inputEngine* e          Engine to run
+
+            Starts a thread calling sampleInputs() every sample_us.
+            Returns 0 on success, -1 if the thread could not be started.
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+int startInputSampler(inputEngine* e);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        stopInputSampler();
+		
+        inputEngine* e          Engine to stop
+
+            Stops and joins the thread started by startInputSampler()
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void stopInputSampler(inputEngine* e);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        enableInputInterrupts();
+
+            Turns on the channel 1 interrupt of the buttons and switches
+            AXI GPIO blocks and clears anything pending, so any edge on
+            an input raises an interrupt for waitForInput()
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void enableInputInterrupts();
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        waitForInput();
+		
+        int timeout_ms          Longest time to sleep, -1 to wait forever
+
+            Sleeps in poll() until a button or switch changes, instead of
+            spinning on getButtonStates(). Needs the UIO backend (the
+            interrupt of each AXI GPIO block arrives on its /dev/uioN)
+            or a descriptor given to setInputEventFd().
+
+            Returns INPUT_SOURCE_BUTTONS and/or INPUT_SOURCE_SWITCHES for
+            what fired, 0 on timeout, -1 on error.
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+int waitForInput(int timeout_ms);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        setInputEventFd();
+		
+        int fd                  eventfd to wait on, -1 to go back to the UIO devices
+
+            Makes waitForInput() wait on an eventfd instead of the UIO
+            interrupts, so input wake-ups can be faked without hardware.
+            Write the INPUT_SOURCE_* bits of what fired; waitForInput()
+            returns them and acknowledges those blocks as it would after
+            a real interrupt. Writes made before one wake-up add up, so
+            write each source once per wake-up.
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void setInputEventFd(int fd);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        outputToLEDs();
+		
+        int val       Value to push to the LEDs
+            
+            Used to display data on LEDs
+            
+        Written by Koby Miller
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void outputToLEDs(int val);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        enableRGB();
+
+        unsigned int select     Binary number to enable each LED    
+
+            Used to enable RGB LEDs.
+            enableRGB(0b11) enables both LEDs
+            enableRGB(0b10) enables only second LED
+            
+        Written by Koby Miller
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void enableRGB(unsigned int select);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        outputToRGB();
+		
+        unsigned int select         Picks which LED to send to 
+        unsigned int color          HEX color to display (0xNNNNNN)
+        float bright                0.0 - 1.0 value to determine brightness of LED
+
+            Used to display light on RGB LEDs
+            Gamma-corrected, see outputToRGBFixed() for the integer-only version
+            
+        Written by Koby Miller
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void outputToRGB(unsigned int select, unsigned int color, float bright);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        outputToRGBFixed();
+		
+        unsigned int select         Picks which LED to send to 
+        unsigned int color          HEX color to display (0xNNNNNN)
+        unsigned short bright       0 - 65535 brightness (RGB_BRIGHT8() converts 0 - 255)
+
+            Integer-only, gamma-corrected RGB output. Channel values and
+            brightness both go through gamma 2.2 lookup tables, so low
+            levels look right, and no floating point is involved. Only
+            width registers whose value changed are written. Any nonzero
+            'select' picks the second LED, as in frameRGB().
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void outputToRGBFixed(unsigned int select, unsigned int color, unsigned short bright);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        animateRGBFade();
+		
+        rgbAnimation* a             Animation to set up
+        unsigned int select         Picks which LED to animate
+        unsigned int from           HEX color to start at
+        unsigned int to             HEX color to end at
+        unsigned long duration_ms   Length of the fade
+        bool eased                  0 for a linear fade, 1 to ease in and out
+
+            Precomputes a one-shot fade between two colors. The first
+            tickRGBAnimation() starts it.
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void animateRGBFade(rgbAnimation* a, unsigned int select, unsigned int from, unsigned int to, unsigned long duration_ms, bool eased);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        animateRGBBreathe();
+		
+        rgbAnimation* a             Animation to set up
+        unsigned int select         Picks which LED to animate
+        unsigned int color          HEX color to breathe
+        unsigned long period_ms     Time of one full breath
+
+            Precomputes a looping breathing effect: brightness rises and
+            falls along a smoothed triangle (close to a raised cosine),
+            gamma-corrected like outputToRGBFixed().
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void animateRGBBreathe(rgbAnimation* a, unsigned int select, unsigned int color, unsigned long period_ms);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        animateRGBCycle();
+		
+        rgbAnimation* a             Animation to set up
+        unsigned int select         Picks which LED to animate
+        const unsigned int* colors  HEX colors to cycle through
+        unsigned int count          Number of colors, at least 1
+        unsigned long step_ms       Time to fade from one color to the next
+
+            Precomputes a looping cross-fade through a list of colors,
+            ending back on the first one. With no colors the animation
+            is finished from the start and never touches the LED
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void animateRGBCycle(rgbAnimation* a, unsigned int select, const unsigned int* colors, unsigned int count, unsigned long step_ms);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        tickRGBAnimation();
+		
+        rgbAnimation* a             Animation to advance
+        unsigned long now           Current time from getMillis()
+
+            Non-blocking. Looks up the keyframe for 'now' (one multiply,
+            no division while inside a pass) and writes only the width
+            registers that changed. The cost per tick doesn't depend on
+            the effect, and nothing is allocated.
+
+            Returns 1 while the animation runs, 0 once a fade has finished.
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+bool tickRGBAnimation(rgbAnimation* a, unsigned long now);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        initOutputQueue();
+		
+        outputQueue* q              Queue to set up
+        unsigned int period_us      Time between flushes of startOutputThread(), 0 for OUTPUT_PERIOD_US
+
+            Asynchronous output. Any number of threads hand commands to
+            queueLEDs(), queueSevSeg(), queueSevSegCustom() and queueRGB()
+            and return at once, without touching the bus. A single I/O
+            thread drains them with flushOutputQueue(): of all the commands
+            queued for one peripheral since the last flush only the newest
+            is converted and written (last writer wins), so the bus sees at
+            most one update per peripheral per flush, however fast the
+            producers run.
+
+            The queue is lock-free and never fills up: each peripheral has
+            one slot that producers overwrite with a single atomic exchange,
+            so they never wait, neither for each other nor for the I/O
+            thread, and the newest command is never turned away. A command
+            that replaces one the I/O thread hasn't written yet counts as
+            coalesced.
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void initOutputQueue(outputQueue* q, unsigned int period_us);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        queueLEDs();
+		
+        outputQueue* q              Queue to submit to
+        int val                     Value for outputToLEDs()
+
+            Safe from any thread, never blocks.
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void queueLEDs(outputQueue* q, int val);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        queueSevSeg();
+		
+        outputQueue* q              Queue to submit to
+        int val                     Value for outputToSevSeg()
+        byte mode                   Mode for outputToSevSeg()
+
+            Safe from any thread, never blocks. The digits are only worked
+            out at flush time, and not at all if a newer command replaces it.
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void queueSevSeg(outputQueue* q, int val, byte mode);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        queueSevSegCustom();
+		
+        outputQueue* q              Queue to submit to
+        const char* str             Up to 4 characters for outputToSevSegCustom()
+
+            Safe from any thread, never blocks. Shares the seven-segment
+            slot with queueSevSeg(), so the newer of the two wins.
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void queueSevSegCustom(outputQueue* q, const char* str);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        queueRGB();
+		
+        outputQueue* q              Queue to submit to
+        unsigned int select         Picks which LED to send to
+        unsigned int color          HEX color to display (0xNNNNNN)
+        unsigned short bright       0 - 65535 brightness, as for outputToRGBFixed()
+
+            Safe from any thread, never blocks. Each RGB LED coalesces
+            on its own.
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void queueRGB(outputQueue* q, unsigned int select, unsigned int color, unsigned short bright);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        flushOutputQueue();
+		
+        outputQueue* q              Queue to drain
+
+            Takes the newest command of each peripheral out of its slot
+            and writes it. Normally run by startOutputThread(); on
+            bare-metal call it from the main loop. A call made while
+            another flush is running returns 0 right away.
+            Returns the number of commands written.
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+unsigned int flushOutputQueue(outputQueue* q);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        startOutputThread();
+		
+        outputQueue* q              Queue to serve
+
+            Starts the I/O thread, calling flushOutputQueue() every period_us.
+            Returns 0 on success, -1 if the thread could not be started
+            (always on bare-metal).
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+int startOutputThread(outputQueue* q);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        stopOutputThread();
+		
+        outputQueue* q              Queue to stop serving
+
+            Stops and joins the I/O thread, then flushes whatever was
+            still pending so the last state always reaches the hardware
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void stopOutputThread(outputQueue* q);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        getOutputQueueStats();
+		
+        outputQueue* q              Queue to query
+        outputQueueStats* s         Filled with the counters
+
+            The coalescing ratio is submitted / written: how many commands
+            the producers issued for every one that cost bus writes.
+            Safe to call while the queue is in use.
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void getOutputQueueStats(outputQueue* q, outputQueueStats* s);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        initDisplaySink();
+		
+        displaySink* d          Sink to set up
+        unsigned int max_hz     Most renders per second, 0 for DISPLAY_SINK_HZ
+
+            Rate-limited seven-segment and LED output for loops that
+            produce values far faster than anyone can read them. The
+            sink*() functions only remember the newest value; at most
+            max_hz times a second it is converted (digits, glyphs) and
+            written. Values replaced before their frame cost nothing
+            beyond the store into the sink and one getNanos() call.
+
+            Single-threaded, like the marquee. Threads share the display
+            through the output queue (initOutputQueue()) instead.
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void initDisplaySink(displaySink* d, unsigned int max_hz);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        sinkSevSeg();
+		
+        displaySink* d          Sink to submit to
+        int val                 Value for outputToSevSeg()
+        byte mode               Mode for outputToSevSeg()
+
+            Keeps the value for the next frame and renders right away if
+            a frame is due. Returns 1 if the display was updated.
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+bool sinkSevSeg(displaySink* d, int val, byte mode);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        sinkSevSegCustom();
+		
+        displaySink* d          Sink to submit to
+        const char* str         Up to 4 characters for outputToSevSegCustom()
+
+            As sinkSevSeg(), replacing any pending number
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+bool sinkSevSegCustom(displaySink* d, const char* str);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        sinkLEDs();
+		
+        displaySink* d          Sink to submit to
+        int val                 Value for outputToLEDs()
+
+            Keeps the value for the next frame and renders right away if
+            a frame is due. Returns 1 if the display was updated.
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+bool sinkLEDs(displaySink* d, int val);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        flushDisplaySink();
+		
+        displaySink* d          Sink to render
+        bool force              Render now, even if the frame isn't due
+
+            Renders pending values once a frame is due. The sink*()
+            functions already do this, so call it from an idle loop to let
+            the last value of a burst land on time, or with 'force' when the
+            value must show immediately (e.g. before exiting).
+            Returns 1 if anything was written.
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+bool flushDisplaySink(displaySink* d, bool force);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        getDisplaySinkStats();
+		
+        displaySink* d              Sink to query
+        unsigned long* submitted    Values handed to the sink
+        unsigned long* rendered     Values converted and written
+
+            Either pointer may be NULL. submitted - rendered values never
+            reached the display, nor cost a conversion or a bus write.
+            
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void getDisplaySinkStats(displaySink* d, unsigned long* submitted, unsigned long* rendered);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        setupPmod();
+		
+        bool io             read (0) or write (1)
+        bool row            top (0) or bottom (1) row
+
+            Enables the mode of PMOD B
+        
+        Written by Koby Miller
+        Originally written by Dr. Jacob Murray
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void setupPmod(bool io, bool row);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        pmodRead();
+		
+        bool row            top (0) or bottom (1) row
+
+            Returns a 4-bit value from the PMOD B row selected
+            Direction is only reprogrammed when the row isn't an input yet
+        
+        Written by Koby Miller
+        Originally written by Dr. Jacob Murray
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+unsigned int pmodRead(bool row);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        pmodWrite();
+		
+        bool row                top (0) or bottom (1) row
+        unsigned int data       data to be written to the selected PMOD B row       
+
+            Writes a 4-bit value to the PMOD B row selected
+            Direction is only reprogrammed when the row isn't an output yet
+        
+        Written by Koby Miller
+        Originally written by Dr. Jacob Murray
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void pmodWrite(bool row, unsigned int data);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        pmodReadFast();
+		
+        bool row            top (0) or bottom (1) row
+
+            Returns a 4-bit value from the PMOD B row selected, assuming
+            the row is already an input. A single load.
+        
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+unsigned int pmodReadFast(bool row);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        pmodWriteFast();
+		
+        bool row                top (0) or bottom (1) row
+        unsigned int data       data to be written to the selected PMOD B row
+
+            Writes a 4-bit value to the PMOD B row selected, assuming the
+            row is already an output. A single store to MASK_DATA_2_LSW,
+            which leaves the other pins of the bank alone, so it is safe
+            to call from several threads without a lock.
+        
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void pmodWriteFast(bool row, unsigned int data);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        pmodWriteBurst();
+		
+        bool row                    top (0) or bottom (1) row
+        const uint8_t* nibbles      4-bit values to write, in order
+        size_t n                    Number of values
+
+            Streams a buffer out of a PMOD B row for bit-banged protocols.
+            Direction is set once, the MASK_DATA_2_LSW words are built a
+            chunk at a time and then stored back to back, so the pins
+            toggle as fast as the bus takes the stores.
+        
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void pmodWriteBurst(bool row, const uint8_t* nibbles, size_t n);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        pmodReadBurst();
+		
+        bool row                    top (0) or bottom (1) row
+        uint8_t* out                Filled with n 4-bit values
+        size_t n                    Number of values
+
+            Samples a PMOD B row n times with back-to-back loads of
+            DATA_2_RO, after setting the direction once
+        
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void pmodReadBurst(bool row, uint8_t* out, size_t n);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        initPmodCapture();
+		
+        pmodCapture* cap            Capture to set up
+        unsigned int capacity       Number of runs (pin changes) the ring holds
+
+            Preallocates the capture ring and sets PMOD_TRIGGER_NONE.
+            Returns 0 on success, -1 if memory ran out.
+        
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+int initPmodCapture(pmodCapture* cap, unsigned int capacity);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        setPmodTrigger();
+		
+        pmodCapture* cap            Capture to configure
+        byte type                   PMOD_TRIGGER_*
+        uint8_t mask                Pins the trigger looks at
+        uint8_t pattern             Pin values for PMOD_TRIGGER_PATTERN
+
+            Chooses what starts the capture
+        
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void setPmodTrigger(pmodCapture* cap, byte type, uint8_t mask, uint8_t pattern);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        runPmodCapture();
+		
+        pmodCapture* cap            Capture to run
+        uint32_t samples            Samples to take after the trigger
+        uint32_t timeout            Samples to wait for the trigger, 0 to wait forever
+
+            Logic analyzer for both PMOD B rows. Samples DATA_2_RO in a
+            tight loop. DATA_2_RO shows pin levels whatever the direction,
+            so pins keep their setup and outputs (the library's own SPI
+            and UART lines too) are captured as well. Only pin changes are
+            stored (run-length encoded), so memory depends on activity
+            rather than length. Timestamps are sample numbers, turned into time
+            from the measured sample rate, so the loop never reads a clock.
+            History before the trigger is kept as long as the ring has
+            room, the oldest runs are overwritten first. A late trigger
+            shortens a huge 'samples' so the total still fits in 32 bits.
+
+            Returns 0 once captured, -1 if the trigger never fired.
+        
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+int runPmodCapture(pmodCapture* cap, uint32_t samples, uint32_t timeout);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        savePmodVCD();
+		
+        const pmodCapture* cap      Capture to export
+        const char* path            File to write
+
+            Writes the capture as a VCD file for waveform viewers (GTKWave,
+            PulseView, ...), one wire per pin plus a 'trigger' wire.
+            Returns 0 on success, -1 if the file could not be written.
+        
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+int savePmodVCD(const pmodCapture* cap, const char* path);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        freePmodCapture();
+		
+        pmodCapture* cap            Capture to release
+
+            Frees the ring allocated by initPmodCapture()
+        
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void freePmodCapture(pmodCapture* cap);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        setupPmodPins();
+		
+        uint8_t pins                PMOD B pins to configure, one bit per pin
+        uint8_t outputs             Which of them become outputs, the rest become inputs
+
+            Per-pin version of setupPmod(), for protocols that mix inputs
+            and outputs on one row. Pins are numbered with PMODB_PIN().
+        
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void setupPmodPins(uint8_t pins, uint8_t outputs);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        simPmodConnect();
+		
+        uint8_t from                PMOD B pin driving the wire, 0xFF to cut the wire
+        uint8_t to                  PMOD B pin reading it
+
+            Simulated backend only. Wires two PMOD B pins together so
+            protocol engines can be tested in loopback on a host: while
+            'to' is an input, DATA_2_RO shows the level of 'from'. Once any
+            wire exists, undriven pins read high as if pulled up.
+        
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void simPmodConnect(uint8_t from, uint8_t to);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        simPmodI2cSlave();
+		
+        uint8_t scl, sda            PMOD B pins (PMODB_PIN()) of the bus, 0xFF to remove the slave
+        uint8_t addr                7-bit address the slave answers to
+
+            Simulated backend only. Puts an I2C slave on two PMOD B pins
+            so pmodI2cWrite() and pmodI2cRead() can be tested on a host.
+            It acknowledges its address and every byte written to it,
+            and leaves every other address unacknowledged. It has no
+            data of its own, so reads return 0xFF. Undriven pins read
+            high from then on, as with simPmodConnect().
+        
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void simPmodI2cSlave(uint8_t scl, uint8_t sda, uint8_t addr);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        simPmodI2cReceived();
+		
+        uint8_t* data               Filled with the bytes written to the slave
+        size_t max                  Room in 'data'
+
+            Simulated backend only. Copies the data bytes the slave of
+            simPmodI2cSlave() acknowledged since it was set up, the
+            first 16 at most. Returns how many were copied.
+        
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+size_t simPmodI2cReceived(uint8_t* data, size_t max);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        initPmodSpi();
+		
+        pmodSpi* spi                SPI master to set up
+        uint8_t sck, mosi, miso, cs PMOD B pins (PMODB_PIN()), cs 0xFF for none
+        byte mode                   SPI mode 0-3
+        unsigned long hz            Clock rate, 0 for as fast as the bus allows
+
+            Software SPI master on PMOD B. Every register word the clock
+            and data pins can need is built here, so a bit costs two
+            table-driven stores and one load. Edges are placed on absolute
+            deadlines, so the clock rate doesn't drift with bus latency.
+        
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void initPmodSpi(pmodSpi* spi, uint8_t sck, uint8_t mosi, uint8_t miso, uint8_t cs, byte mode, unsigned long hz);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        pmodSpiTransfer();
+		
+        pmodSpi* spi                SPI master to use
+        const uint8_t* tx           Bytes to send, NULL to send 0xFF
+        uint8_t* rx                 Filled with the bytes received, may be NULL
+        size_t n                    Number of bytes
+
+            Full-duplex transfer, MSB first, with chip select held low throughout
+        
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void pmodSpiTransfer(pmodSpi* spi, const uint8_t* tx, uint8_t* rx, size_t n);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        initPmodI2c();
+		
+        pmodI2c* i2c                I2C master to set up
+        uint8_t scl, sda            PMOD B pins (PMODB_PIN()), need external pull-ups
+        unsigned long hz            Clock rate
+
+            Software I2C master on PMOD B. Lines are open-drain: a low is
+            an output driving 0, a high is an input left to the pull-up,
+            so each edge is one DIR_2 store. The word is built from the
+            DIR_2 shadow, so other PMOD B pins keep whatever direction
+            they were given since. Clock stretching by the slave is honored.
+        
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void initPmodI2c(pmodI2c* i2c, uint8_t scl, uint8_t sda, unsigned long hz);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        pmodI2cWrite();
+		
+        pmodI2c* i2c                I2C master to use
+        uint8_t addr                7-bit slave address
+        const uint8_t* data         Bytes to write
+        size_t n                    Number of bytes
+
+            Returns 0 if every byte was acknowledged, -1 on a NACK
+        
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+int pmodI2cWrite(pmodI2c* i2c, uint8_t addr, const uint8_t* data, size_t n);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        pmodI2cRead();
+		
+        pmodI2c* i2c                I2C master to use
+        uint8_t addr                7-bit slave address
+        uint8_t* data               Filled with the bytes read
+        size_t n                    Number of bytes
+
+            Returns 0 on success, -1 if the address was not acknowledged
+        
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+int pmodI2cRead(pmodI2c* i2c, uint8_t addr, uint8_t* data, size_t n);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        initPmodUart();
+		
+        pmodUart* uart              UART to set up
+        uint8_t tx, rx              PMOD B pins (PMODB_PIN())
+        unsigned long baud          Bit rate
+
+            Software 8N1 UART on PMOD B. TX idles high. Bits are placed on
+            absolute deadlines from the start bit, so timing errors don't
+            add up across a frame.
+        
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void initPmodUart(pmodUart* uart, uint8_t tx, uint8_t rx, unsigned long baud);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        pmodUartWrite();
+		
+        pmodUart* uart              UART to use
+        const uint8_t* data         Bytes to send
+        size_t n                    Number of bytes
+
+            Sends bytes, blocking until the last stop bit is out
+        
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+void pmodUartWrite(pmodUart* uart, const uint8_t* data, size_t n);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+        pmodUartRead();
+		
+        pmodUart* uart              UART to use
+        uint8_t* data               Filled with the bytes received
+        size_t n                    Number of bytes wanted
+        unsigned int timeout_ms     Longest wait for each start bit
+
+            Receives bytes, sampling each bit in its middle.
+            Returns the number of bytes received before a timeout.
+        
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+size_t pmodUartRead(pmodUart* uart, uint8_t* data, size_t n, unsigned int timeout_ms);
+
+/* +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+  
+        HEADER-ONLY ACCESSORS
+
+            Building with -DKLIB_IO_INLINE replaces the hot-path functions
+            below with static inline versions that store straight through
+            the *_REGS pointers. Constant arguments then fold at the call
+            site, e.g. outputToLEDs(0x3FF) becomes a single str, with no
+            call and no offset arithmetic at run time.
+
+            These accessors use physical addresses, so they are for the
+            bare-metal backend only. They skip the shadow registers and MMIO
+            tracing, so call invalidateShadow() before going back to the
+            library versions of the same registers.
+
++-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+ */
+#if defined(KLIB_IO_INLINE) && !defined(KLIB_IO_LIBRARY_SOURCE)
+
+static inline void klibInlineLEDs(int val) {
+    LED_REGS->data = val & 0b1111111111;
+}
+
+static inline unsigned int klibInlineButtons() {
+    return BUTTONS_REGS->data & 0b1111;
+}
+
+static inline unsigned int klibInlineSwitches() {
+    return SWITCHES_REGS->data & 0b111111111111;
+}
+
+static inline void klibInlineSevSegFrame(unsigned int frame) {
+    SEVSEG_REGS->ctrl = 0b11; // custom mode
+    SEVSEG_REGS->data = frame;
+}
+
+static inline void klibInlineEnableRGB(unsigned int select) {
+
+    const unsigned int one = select & 1;
+    const unsigned int two = (select >> 1) & 1;
+
+    RGB_REGS->ch[0].en = one;
+    RGB_REGS->ch[1].en = one;
+    RGB_REGS->ch[2].en = one;
+    RGB_REGS->ch[3].en = two;
+    RGB_REGS->ch[4].en = two;
+    RGB_REGS->ch[5].en = two;
+}
+
+static inline unsigned int klibInlinePmodReadFast(bool row) {
+    return (GPIO_PS_REGS->data_2_ro >> (row ? 11 : 7)) & 0xF;
+}
+
+static inline void klibInlinePmodWriteFast(bool row, unsigned int data) {
+
+    const unsigned int mask = row ? PMODB_BOTTOM_MASK : PMODB_TOP_MASK;
+
+    GPIO_PS_REGS->mask_data_2_lsw = ((~mask & 0xFFFF) << 16) | ((data << (row ? 11 : 7)) & mask);
+}
+
+#define outputToLEDs(val) klibInlineLEDs(val)
+#define getButtonStates() klibInlineButtons()
+#define getSwitchStates() klibInlineSwitches()
+#define outputToSevSegFrame(frame) klibInlineSevSegFrame(frame)
+#define enableRGB(select) klibInlineEnableRGB(select)
+#define pmodReadFast(row) klibInlinePmodReadFast(row)
+#define pmodWriteFast(row, data) klibInlinePmodWriteFast(row, data)
+
+#endif
 
 #endif
\ No newline at end of file